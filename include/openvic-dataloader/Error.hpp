@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string_view>
 
+#include <openvic-dataloader/NodeLocation.hpp>
 #include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/detail/Utility.hpp>
 
@@ -64,7 +65,7 @@ namespace ovdl::error {
 		}
 	}
 
-	struct Error : dryad::abstract_node_all<ErrorKind> {
+	struct Error : dryad::abstract_node_all<ErrorKind>, LocationSlot {
 		const char* message(const ErrorSymbolInterner::symbol_interner_type& symbols) const { return _message.c_str(); }
 
 	protected:
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cassert>
+#include <concepts> // IWYU pragma: keep
 #include <cstdint>
+#include <vector>
 
 namespace ovdl {
 	template<typename CharT>
@@ -70,6 +73,100 @@ namespace ovdl {
 
 	using NodeLocation = BasicNodeLocation<char>;
 
+	/// NodeLocation stored as 32-bit offsets from the start of the buffer it points into.
+	///
+	/// Half the size of the pointer form and independent of where the buffer lives, so it stays valid when the
+	/// buffer is moved or the locations are serialized.
+	struct CompactNodeLocation {
+		static constexpr std::uint32_t synthesized_offset = std::uint32_t(-1);
+
+		std::uint32_t _begin = synthesized_offset;
+		std::uint32_t _end = synthesized_offset;
+
+		CompactNodeLocation() = default;
+		CompactNodeLocation(std::uint32_t begin, std::uint32_t end)
+			: _begin(begin),
+			  _end(end) {}
+
+		/// loc must be synthesized or point into the buffer starting at buffer_begin.
+		static CompactNodeLocation from(NodeLocation loc, const char* buffer_begin) {
+			if (loc.is_synthesized()) {
+				return {};
+			}
+			assert(buffer_begin != nullptr && loc.begin() >= buffer_begin && loc.end() >= loc.begin());
+			assert(std::size_t(loc.end() - buffer_begin) < synthesized_offset);
+			return { std::uint32_t(loc.begin() - buffer_begin), std::uint32_t(loc.end() - buffer_begin) };
+		}
+
+		NodeLocation to_location(const char* buffer_begin) const {
+			if (is_synthesized()) {
+				return {};
+			}
+			return { buffer_begin + _begin, buffer_begin + _end };
+		}
+
+		std::uint32_t begin_offset() const { return _begin; }
+		std::uint32_t end_offset() const { return _end; }
+
+		bool is_synthesized() const { return _begin == synthesized_offset; }
+
+		friend bool operator==(const CompactNodeLocation&, const CompactNodeLocation&) = default;
+	};
+
+	/// Index of a node's location in the NodeLocationTable of the file or logger that created it.
+	///
+	/// Node bases holding a slot are found by ADL through location_slot(node), their locations are then stored
+	/// densely by index instead of in a node map.
+	struct LocationSlot {
+		static constexpr std::uint32_t npos = std::uint32_t(-1);
+
+		std::uint32_t location_index() const { return _location_index; }
+
+	private:
+		mutable std::uint32_t _location_index = npos;
+
+		friend struct NodeLocationTable;
+	};
+
+	/// Dense array of compact node locations indexed by LocationSlot.
+	struct NodeLocationTable {
+		/// Assigns slot the next index on its first location.
+		void set(const LocationSlot& slot, CompactNodeLocation loc) {
+			if (slot._location_index == LocationSlot::npos) {
+				slot._location_index = std::uint32_t(_locations.size());
+				_locations.push_back(loc);
+			} else {
+				_locations[slot._location_index] = loc;
+			}
+		}
+
+		/// Returns nullptr if no location was set for slot.
+		const CompactNodeLocation* find(const LocationSlot& slot) const {
+			if (slot._location_index >= _locations.size()) {
+				return nullptr;
+			}
+			return &_locations[slot._location_index];
+		}
+
+		void reserve(std::size_t size) {
+			_locations.reserve(size);
+		}
+
+		std::size_t size() const {
+			return _locations.size();
+		}
+
+	private:
+		std::vector<CompactNodeLocation> _locations;
+	};
+
+	namespace detail {
+		template<typename NodeT>
+		concept HasLocationSlot = requires(const NodeT* node) {
+			{ location_slot(node) } -> std::convertible_to<const LocationSlot*>;
+		};
+	}
+
 	struct FilePosition {
 		std::uint32_t start_line = std::uint32_t(-1), end_line = std::uint32_t(-1), start_column = std::uint32_t(-1), end_column = std::uint32_t(-1);
 
@@ -10,6 +10,7 @@
 #include <openvic-dataloader/detail/Concepts.hpp>
 #include <openvic-dataloader/detail/Encoding.hpp>
 #include <openvic-dataloader/detail/ErrorRange.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
 
 namespace ovdl::csv {
 	class Parser final : public detail::BasicParser {
@@ -17,6 +18,10 @@ namespace ovdl::csv {
 		Parser();
 		Parser(std::basic_ostream<char>& error_stream);
 
+		/// Selects how symbols of buffers loaded afterwards are stored, overriding default_symbol_storage().
+		/// Chunked storage reserves no address space up front, which helps when many parsers are alive at once.
+		void set_symbol_storage(symbol_storage storage);
+
 		static Parser from_buffer(const char* data, std::size_t size, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
 		static Parser from_buffer(const char* start, const char* end, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
 		static Parser from_string(const std::string_view string, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include <openvic-dataloader/detail/HashAlgorithm.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+
+namespace ovdl {
+	/// Thread-safe symbol interner for parsers running on several threads.
+	///
+	/// Symbols are distributed over 2^ShardBits shards by hash. Each shard serializes its writers with its
+	/// own mutex, while lookups never lock: hash tables are replaced instead of rehashed in place and
+	/// retired tables stay alive until the interner is destroyed. Symbol strings and entries are
+	/// append-only, so symbols and handles are stable for the lifetime of the interner.
+	///
+	/// Handle ids are (shard-local index << ShardBits) | shard, they are unique but only dense per shard.
+	template<typename Id, typename CharT = char, typename IndexType = std::uint32_t, std::size_t ShardBits = 4>
+	class concurrent_symbol_interner {
+		static_assert(std::is_trivial_v<CharT>);
+		static_assert(std::is_unsigned_v<IndexType>);
+		static_assert(ShardBits < sizeof(IndexType) * 8);
+
+		static constexpr std::size_t shard_count = std::size_t(1) << ShardBits;
+		static constexpr std::size_t shard_mask = shard_count - 1;
+
+		static constexpr IndexType unoccupied = IndexType(-1);
+
+		struct entry {
+			const CharT* ptr;
+			IndexType length;
+			std::uint32_t hash;
+		};
+
+		struct table {
+			explicit table(std::size_t capacity)
+				: capacity(capacity),
+				  slots(std::make_unique<std::atomic<IndexType>[]>(capacity)) {
+				for (std::size_t i = 0; i < capacity; ++i) {
+					slots[i].store(unoccupied, std::memory_order_relaxed);
+				}
+			}
+
+			std::size_t capacity;
+			std::unique_ptr<std::atomic<IndexType>[]> slots;
+		};
+
+		class shard {
+			// Segment k holds first_segment_size << k entries, segments are never moved once allocated.
+			static constexpr std::size_t first_segment_size = 256;
+			static constexpr std::size_t segment_count = sizeof(IndexType) * 8;
+
+			static constexpr std::size_t string_block_size = 16 * 1024;
+			static constexpr std::size_t min_table_size = 1024;
+
+		public:
+			shard() {
+				auto initial = std::make_unique<table>(min_table_size);
+				_table.store(initial.get(), std::memory_order_relaxed);
+				_tables.push_back(std::move(initial));
+				for (auto& segment : _segments) {
+					segment.store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			~shard() {
+				for (auto& segment : _segments) {
+					delete[] segment.load(std::memory_order_relaxed);
+				}
+			}
+
+			shard(const shard&) = delete;
+			shard& operator=(const shard&) = delete;
+
+			IndexType find(const CharT* str, std::size_t length, std::uint64_t hash) const {
+				return _find_in(*_table.load(std::memory_order_acquire), str, length, hash);
+			}
+
+			template<typename OnInsert>
+			IndexType intern(const CharT* str, std::size_t length, std::uint64_t hash, OnInsert&& on_insert) {
+				if (auto local = find(str, length, hash); local != unoccupied) {
+					return local;
+				}
+
+				std::lock_guard lock { _mutex };
+
+				// Another writer may have inserted it between the lookup and taking the lock.
+				auto* current = _table.load(std::memory_order_relaxed);
+				if (auto local = _find_in(*current, str, length, hash); local != unoccupied) {
+					return local;
+				}
+
+				auto local = _size.load(std::memory_order_relaxed);
+				if (local + 1 >= (std::size_t(unoccupied) >> ShardBits)) { // Overflow of index type.
+					return unoccupied;
+				}
+
+				if ((local + 1) * 2 > current->capacity) {
+					current = _grow(current->capacity * 2, local);
+				}
+
+				auto& segment_entry = _entry_for_write(local);
+				segment_entry = entry { _store_string(str, length), IndexType(length), std::uint32_t(hash) };
+				_size.store(local + 1, std::memory_order_release);
+
+				_insert_in(*current, IndexType(local), hash);
+				on_insert();
+
+				return IndexType(local);
+			}
+
+			const entry& get(IndexType local) const {
+				auto [segment, offset] = _locate(local);
+				auto* data = _segments[segment].load(std::memory_order_acquire);
+				assert(data != nullptr);
+				return data[offset];
+			}
+
+			std::size_t size() const {
+				return _size.load(std::memory_order_acquire);
+			}
+
+		private:
+			static std::pair<std::size_t, std::size_t> _locate(std::size_t local) {
+				auto segment = std::size_t(std::bit_width(local / first_segment_size + 1) - 1);
+				auto offset = local - first_segment_size * ((std::size_t(1) << segment) - 1);
+				return { segment, offset };
+			}
+
+			IndexType _find_in(const table& t, const CharT* str, std::size_t length, std::uint64_t hash) const {
+				auto mask = t.capacity - 1;
+				for (auto index = std::size_t(hash) & mask;; index = (index + 1) & mask) {
+					auto local = t.slots[index].load(std::memory_order_acquire);
+					if (local == unoccupied) {
+						return unoccupied;
+					}
+
+					const auto& existing = get(local);
+					if (existing.hash == std::uint32_t(hash) && existing.length == length &&
+						std::memcmp(existing.ptr, str, length * sizeof(CharT)) == 0) {
+						return local;
+					}
+				}
+			}
+
+			static void _insert_in(table& t, IndexType local, std::uint64_t hash) {
+				auto mask = t.capacity - 1;
+				for (auto index = std::size_t(hash) & mask;; index = (index + 1) & mask) {
+					if (t.slots[index].load(std::memory_order_relaxed) == unoccupied) {
+						t.slots[index].store(local, std::memory_order_release);
+						return;
+					}
+				}
+			}
+
+			table* _grow(std::size_t capacity, std::size_t size) {
+				auto grown = std::make_unique<table>(capacity);
+				for (std::size_t local = 0; local < size; ++local) {
+					// Only the low hash bits are used for probing, so the stored 32 bits suffice.
+					_insert_in(*grown, IndexType(local), get(IndexType(local)).hash);
+				}
+
+				// Readers still probing the old table finish on it, it is kept until destruction.
+				auto* result = grown.get();
+				_tables.push_back(std::move(grown));
+				_table.store(result, std::memory_order_release);
+				return result;
+			}
+
+			entry& _entry_for_write(std::size_t local) {
+				auto [segment, offset] = _locate(local);
+				auto* data = _segments[segment].load(std::memory_order_relaxed);
+				if (data == nullptr) {
+					data = new entry[first_segment_size << segment];
+					_segments[segment].store(data, std::memory_order_release);
+				}
+				return data[offset];
+			}
+
+			const CharT* _store_string(const CharT* str, std::size_t length) {
+				// +1 for null-terminator.
+				auto required = length + 1;
+				if (_block_remaining < required) {
+					auto block_size = std::max(required, string_block_size);
+					_blocks.push_back(std::make_unique<CharT[]>(block_size));
+					_block_head = _blocks.back().get();
+					_block_remaining = block_size;
+				}
+
+				auto* result = _block_head;
+				std::memcpy(result, str, length * sizeof(CharT));
+				result[length] = CharT(0);
+
+				_block_head += required;
+				_block_remaining -= required;
+				return result;
+			}
+
+			std::atomic<table*> _table;
+			std::atomic<std::size_t> _size = 0;
+			std::array<std::atomic<entry*>, segment_count> _segments;
+
+			// Only touched by writers while holding _mutex.
+			std::mutex _mutex;
+			std::vector<std::unique_ptr<table>> _tables;
+			std::vector<std::unique_ptr<CharT[]>> _blocks;
+			CharT* _block_head = nullptr;
+			std::size_t _block_remaining = 0;
+		};
+
+	public:
+		using symbol = ovdl::symbol<CharT>;
+		using symbol_handle = ovdl::symbol_handle<IndexType>;
+
+		concurrent_symbol_interner() = default;
+
+		concurrent_symbol_interner(const concurrent_symbol_interner&) = delete;
+		concurrent_symbol_interner& operator=(const concurrent_symbol_interner&) = delete;
+
+		//=== interning ===//
+		symbol find_intern(const CharT* str, std::size_t length) const {
+			return resolve(find_handle(str, length));
+		}
+		template<std::size_t N>
+		symbol find_intern(const CharT (&literal)[N]) const {
+			assert(literal[N - 1] == CharT(0));
+			return find_intern(literal, N - 1);
+		}
+
+		symbol_handle find_handle(const CharT* str, std::size_t length) const {
+			auto hash = _hash(str, length);
+			auto shard_index = _shard_of(hash);
+			auto local = _shards[shard_index].find(str, length, hash);
+			return _to_handle(local, shard_index);
+		}
+		template<std::size_t N>
+		symbol_handle find_handle(const CharT (&literal)[N]) const {
+			assert(literal[N - 1] == CharT(0));
+			return find_handle(literal, N - 1);
+		}
+
+		symbol intern(const CharT* str, std::size_t length) {
+			return resolve(intern_handle(str, length));
+		}
+		template<std::size_t N>
+		symbol intern(const CharT (&literal)[N]) {
+			assert(literal[N - 1] == CharT(0));
+			return intern(literal, N - 1);
+		}
+
+		symbol_handle intern_handle(const CharT* str, std::size_t length) {
+			auto hash = _hash(str, length);
+			auto shard_index = _shard_of(hash);
+			auto local = _shards[shard_index].intern(str, length, hash, [this] {
+				_size.fetch_add(1, std::memory_order_relaxed);
+			});
+			return _to_handle(local, shard_index);
+		}
+		template<std::size_t N>
+		symbol_handle intern_handle(const CharT (&literal)[N]) {
+			assert(literal[N - 1] == CharT(0));
+			return intern_handle(literal, N - 1);
+		}
+
+		//=== access ===//
+		symbol resolve(symbol_handle handle) const {
+			if (!handle) {
+				return symbol();
+			}
+
+			const auto& existing = _shards[handle.id() & shard_mask].get(IndexType(handle.id() >> ShardBits));
+			return symbol(existing.ptr, existing.length);
+		}
+
+		/// Number of unique symbols.
+		std::size_t size() const {
+			return _size.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static std::uint64_t _hash(const CharT* str, std::size_t length) {
+			return detail::DefaultHash()
+				.hash_bytes(reinterpret_cast<const unsigned char*>(str), length * sizeof(CharT))
+				.finish();
+		}
+
+		// Shards use the high hash bits so the low bits stay independent for table probing.
+		static std::size_t _shard_of(std::uint64_t hash) {
+			if constexpr (ShardBits == 0) {
+				return 0;
+			} else {
+				return std::size_t(hash >> (64 - ShardBits));
+			}
+		}
+
+		static symbol_handle _to_handle(IndexType local, std::size_t shard_index) {
+			if (local == unoccupied) {
+				return symbol_handle();
+			}
+			return symbol_handle(IndexType((local << ShardBits) | shard_index));
+		}
+
+		std::array<shard, shard_count> _shards;
+		std::atomic<std::size_t> _size = 0;
+	};
+
+	struct ConcurrentSymbolIntern {
+		struct SymbolId;
+		using index_type = SymbolIntern::index_type;
+		using symbol_type = SymbolIntern::symbol_type;
+		using symbol_handle_type = SymbolIntern::symbol_handle_type;
+		using symbol_interner_type = concurrent_symbol_interner<SymbolId, symbol_type::char_type, index_type>;
+	};
+
+	/// Resolves handles in whichever interner a tree interned into, sequential or concurrent.
+	///
+	/// Usable wherever nodes take a symbol resolver, like FlatValue::value.
+	struct SymbolResolver {
+		const SymbolIntern::symbol_interner_type* symbol_interner = nullptr;
+		const ConcurrentSymbolIntern::symbol_interner_type* concurrent_symbol_interner = nullptr;
+
+		SymbolIntern::symbol_type resolve(SymbolIntern::symbol_handle_type handle) const {
+			if (concurrent_symbol_interner != nullptr) {
+				return concurrent_symbol_interner->resolve(handle);
+			}
+			return symbol_interner != nullptr ? symbol_interner->resolve(handle) : SymbolIntern::symbol_type();
+		}
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <bit>
 #include <cassert>
 #include <climits>
@@ -9,6 +10,18 @@
 #include <openvic-dataloader/detail/Utility.hpp>
 
 namespace ovdl::detail {
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+	struct HashTableStatistics {
+		std::size_t size = 0;
+		std::size_t capacity = 0;
+		double load_factor = 0;
+		// Number of entries compared to find an existing value, 1 when it is in its ideal slot.
+		double average_probe_length = 0;
+		std::size_t max_probe_length = 0;
+		std::size_t rehash_count = 0;
+	};
+#endif
+
 	/// A simple hash table for trivial keys with linear probing.
 	/// It is non-owning as it does not store the used memory resource.
 	template<typename Traits, std::size_t MinTableSize>
@@ -72,9 +85,14 @@ namespace ovdl::detail {
 		// invalid. Invariants of map are broken until the ptr has been written to.
 		template<typename Key>
 		entry_handle lookup_entry(const Key& key, Traits traits = {}) {
+			return lookup_entry_hashed(key, traits.hash(key), traits);
+		}
+
+		// Same as lookup_entry, with hash being traits.hash(key) computed beforehand.
+		template<typename Key>
+		entry_handle lookup_entry_hashed(const Key& key, std::size_t hash, Traits traits = {}) {
 			assert(_table_size < _table_capacity);
 
-			auto hash = traits.hash(key);
 			auto table_idx = hash & (_table_capacity - 1);
 
 			while (true) {
@@ -104,6 +122,13 @@ namespace ovdl::detail {
 			return entry ? &entry.get() : nullptr;
 		}
 
+		// Prefetches the first entry probed for hash.
+		void prefetch(std::size_t hash) const {
+			if (_table_capacity > 0) {
+				detail::prefetch(_table + (hash & (_table_capacity - 1)));
+			}
+		}
+
 		bool should_rehash() const {
 			return _table_size >= _table_capacity / 2;
 		}
@@ -125,6 +150,9 @@ namespace ovdl::detail {
 			if (new_capacity <= _table_capacity) {
 				return;
 			}
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+			++_rehash_count;
+#endif
 
 			auto old_table = _table;
 			auto old_capacity = _table_capacity;
@@ -255,9 +283,45 @@ namespace ovdl::detail {
 			return { this };
 		}
 
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+		using statistics = HashTableStatistics;
+
+		/// Walks the whole table, meant for tuning and diagnostics rather than hot paths.
+		statistics compute_statistics(Traits traits = {}) const {
+			statistics result {
+				.size = _table_size,
+				.capacity = _table_capacity,
+				.rehash_count = _rehash_count,
+			};
+			if (_table_size == 0) {
+				return result;
+			}
+
+			result.load_factor = double(_table_size) / double(_table_capacity);
+
+			std::size_t total_probe_length = 0;
+			for (std::size_t index = 0; index < _table_capacity; ++index) {
+				if (Traits::is_unoccupied(_table[index])) {
+					continue;
+				}
+
+				auto ideal_index = traits.hash(_table[index]) & (_table_capacity - 1);
+				auto probe_length = ((index - ideal_index) & (_table_capacity - 1)) + 1;
+				total_probe_length += probe_length;
+				result.max_probe_length = std::max(result.max_probe_length, probe_length);
+			}
+			result.average_probe_length = double(total_probe_length) / double(_table_size);
+
+			return result;
+		}
+#endif
+
 	private:
 		value_type* _table = nullptr;
 		std::size_t _table_capacity = 0; // power of two
 		std::size_t _table_size = 0;
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+		std::size_t _rehash_count = 0;
+#endif
 	};
 }
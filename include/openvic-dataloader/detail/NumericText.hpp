@@ -0,0 +1,256 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace ovdl::detail {
+	/// Digits with an optional leading sign.
+	constexpr bool is_integer_text(std::string_view text) {
+		if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+			text.remove_prefix(1);
+		}
+		if (text.empty()) {
+			return false;
+		}
+		for (char c : text) {
+			if (c < '0' || c > '9') {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// Digits around a single '.' with an optional leading sign, at least one digit in total.
+	constexpr bool is_decimal_text(std::string_view text) {
+		if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+			text.remove_prefix(1);
+		}
+		bool has_digit = false, has_dot = false;
+		for (char c : text) {
+			if (c == '.') {
+				if (has_dot) {
+					return false;
+				}
+				has_dot = true;
+			} else if (c >= '0' && c <= '9') {
+				has_digit = true;
+			} else {
+				return false;
+			}
+		}
+		return has_digit && has_dot;
+	}
+
+	/// Three unsigned digit groups separated by '.', like 1836.1.1.
+	constexpr bool is_date_text(std::string_view text) {
+		std::size_t groups = 1, group_digits = 0;
+		for (char c : text) {
+			if (c == '.') {
+				if (group_digits == 0) {
+					return false;
+				}
+				++groups;
+				group_digits = 0;
+			} else if (c >= '0' && c <= '9') {
+				++group_digits;
+			} else {
+				return false;
+			}
+		}
+		return groups == 3 && group_digits != 0;
+	}
+
+	/// Whether all eight bytes at chars are ASCII digits.
+	inline bool is_eight_digits(const char* chars) {
+		std::uint64_t word;
+		std::memcpy(&word, chars, sizeof(word));
+		// Bytes below '0' borrow into their high bit, bytes above '9' carry into it.
+		return (((word + 0x4646464646464646ull) | (word - 0x3030303030303030ull)) & 0x8080808080808080ull) == 0;
+	}
+
+	/// Value of eight ASCII digits, combined pairwise within one 64-bit word.
+	inline std::uint32_t parse_eight_digits(const char* digits) {
+		if constexpr (std::endian::native == std::endian::little) {
+			std::uint64_t word;
+			std::memcpy(&word, digits, sizeof(word));
+			word -= 0x3030303030303030ull;
+			word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFull;
+			word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFull;
+			return std::uint32_t((word * 10000 + (word >> 32)) & 0xFFFFFFFFull);
+		} else {
+			std::uint32_t result = 0;
+			for (std::size_t i = 0; i < 8; ++i) {
+				result = result * 10 + std::uint32_t(digits[i] - '0');
+			}
+			return result;
+		}
+	}
+
+	inline std::optional<std::int64_t> parse_integer_text(std::string_view text) {
+		auto digits = text;
+		if (!digits.empty() && (digits.front() == '-' || digits.front() == '+')) {
+			digits.remove_prefix(1);
+		}
+		// Only a single sign, "+-5" is not an integer.
+		if (digits.empty() || digits.front() < '0' || digits.front() > '9') {
+			return std::nullopt;
+		}
+		bool is_negative = text.front() == '-';
+
+		// Up to 8 digits are validated and parsed as one word, right aligned behind '0' padding.
+		if (digits.size() <= 8) {
+			char padded[8] { '0', '0', '0', '0', '0', '0', '0', '0' };
+			for (std::size_t i = 0; i < digits.size(); ++i) {
+				padded[8 - digits.size() + i] = digits[i];
+			}
+			if (!is_eight_digits(padded)) {
+				return std::nullopt;
+			}
+			auto magnitude = std::int64_t(parse_eight_digits(padded));
+			return is_negative ? -magnitude : magnitude;
+		}
+
+		// from_chars accepts a leading '-' but no '+'.
+		auto signed_digits = is_negative ? text : digits;
+		std::int64_t result;
+		auto [end, error] = std::from_chars(signed_digits.data(), signed_digits.data() + signed_digits.size(), result);
+		if (error != std::errc {} || end != signed_digits.data() + signed_digits.size()) {
+			return std::nullopt;
+		}
+		return result;
+	}
+
+	inline std::optional<double> parse_decimal_text(std::string_view text) {
+		if (!text.empty() && text.front() == '+') {
+			text.remove_prefix(1);
+			// from_chars would still accept the '-' of "+-0.5".
+			if (!text.empty() && text.front() == '-') {
+				return std::nullopt;
+			}
+		}
+		double result;
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), result);
+		if (error != std::errc {} || end != text.data() + text.size()) {
+			return std::nullopt;
+		}
+		return result;
+	}
+
+	/// Integer or decimal text as a signed fixed-point value with fractional_bits fractional bits, at most 62.
+	///
+	/// Exact: the result is the decimal value times 2^fractional_bits rounded to nearest, ties away from zero,
+	/// without going through floating point. Fails for other text and results that do not fit in 64 bits.
+	inline std::optional<std::int64_t> parse_fixed_point_text(std::string_view text, unsigned fractional_bits) {
+		if (fractional_bits > 62 || (!is_integer_text(text) && !is_decimal_text(text))) {
+			return std::nullopt;
+		}
+
+		bool is_negative = text.front() == '-';
+		if (text.front() == '-' || text.front() == '+') {
+			text.remove_prefix(1);
+		}
+
+		auto dot = text.find('.');
+		auto integer_digits = text.substr(0, dot);
+		auto fraction_digits = dot == std::string_view::npos ? std::string_view {} : text.substr(dot + 1);
+		while (!fraction_digits.empty() && fraction_digits.back() == '0') {
+			fraction_digits.remove_suffix(1);
+		}
+
+		std::uint64_t integer = 0;
+		if (!integer_digits.empty()) {
+			auto [end, error] = std::from_chars(integer_digits.data(), integer_digits.data() + integer_digits.size(), integer);
+			if (error != std::errc {}) {
+				return std::nullopt;
+			}
+		}
+		// Leaves room for the rounding carry and the sign.
+		if (integer > (std::uint64_t(std::numeric_limits<std::int64_t>::max()) >> fractional_bits)) {
+			return std::nullopt;
+		}
+
+		std::uint64_t fraction = 0;
+		bool rounds_up = false;
+		bool is_scaled = false;
+		if (fraction_digits.size() <= 18) {
+			// fraction / 10^k with k <= 18, scaled directly while fraction << fractional_bits fits.
+			std::uint64_t numerator = 0, denominator = 1;
+			for (char c : fraction_digits) {
+				numerator = numerator * 10 + std::uint64_t(c - '0');
+				denominator *= 10;
+			}
+			if (std::bit_width(numerator) + fractional_bits <= 64) {
+				auto scaled = numerator << fractional_bits;
+				fraction = scaled / denominator;
+				rounds_up = (scaled % denominator) >= denominator - (scaled % denominator);
+				is_scaled = true;
+			}
+		}
+		if (!is_scaled) {
+			// Produces one binary digit per doubling of the decimal fraction digits.
+			std::vector<std::uint8_t> digits(fraction_digits.size());
+			for (std::size_t i = 0; i < digits.size(); ++i) {
+				digits[i] = std::uint8_t(fraction_digits[i] - '0');
+			}
+			auto double_digits = [&] {
+				std::uint8_t carry = 0;
+				for (std::size_t i = digits.size(); i-- > 0;) {
+					auto doubled = std::uint8_t(digits[i] * 2 + carry);
+					digits[i] = doubled % 10;
+					carry = doubled / 10;
+				}
+				return carry;
+			};
+			for (unsigned bit = 0; bit < fractional_bits; ++bit) {
+				fraction = (fraction << 1) | double_digits();
+			}
+			rounds_up = double_digits() != 0;
+		}
+
+		auto magnitude = (integer << fractional_bits) + fraction + (rounds_up ? 1 : 0);
+		if (magnitude > std::uint64_t(std::numeric_limits<std::int64_t>::max())) {
+			return std::nullopt;
+		}
+		return is_negative ? -std::int64_t(magnitude) : std::int64_t(magnitude);
+	}
+
+	struct date_parts {
+		std::int32_t year;
+		std::uint8_t month;
+		std::uint8_t day;
+
+		friend bool operator==(const date_parts&, const date_parts&) = default;
+	};
+
+	/// Fails for text that is not date text or whose parts overflow, months and days are not range checked.
+	inline std::optional<date_parts> parse_date_text(std::string_view text) {
+		if (!is_date_text(text)) {
+			return std::nullopt;
+		}
+
+		std::uint32_t parts[3] {};
+		const char* current = text.data();
+		const char* end = text.data() + text.size();
+		for (std::size_t i = 0; i < 3; ++i) {
+			auto [next, error] = std::from_chars(current, end, parts[i]);
+			if (error != std::errc {}) {
+				return std::nullopt;
+			}
+			// Skips the separator.
+			current = i < 2 ? next + 1 : next;
+		}
+
+		if (parts[0] > std::uint32_t(INT32_MAX) || parts[1] > UINT8_MAX || parts[2] > UINT8_MAX) {
+			return std::nullopt;
+		}
+		return date_parts { std::int32_t(parts[0]), std::uint8_t(parts[1]), std::uint8_t(parts[2]) };
+	}
+}
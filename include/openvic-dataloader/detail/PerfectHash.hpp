@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace ovdl::detail {
+	/// Minimal perfect hash over a fixed set of values, built with hash-and-displace.
+	///
+	/// Values are grouped into buckets by their hash, every bucket stores one seed which displaces all of its
+	/// values into distinct slots of a table with exactly one slot per value. Lookups hash once, read one seed
+	/// and one slot and return the only candidate value, which the caller still has to compare against the key.
+	/// It is immutable once built, so concurrent lookups need no synchronization.
+	template<typename ValueType>
+	class PerfectHashTable {
+		// Buckets placed without a seed search store their slot directly, marked by this bit.
+		static constexpr std::uint32_t direct_slot = std::uint32_t(1) << 31;
+		static constexpr std::uint32_t max_seed_attempts = 1 << 20;
+		static constexpr std::size_t average_bucket_size = 4;
+
+	public:
+		constexpr PerfectHashTable() = default;
+
+		/// hashes[i] is the hash of values[i], all hashes must be distinct.
+		/// Returns false if no table could be built, leaving this table empty.
+		bool build(const std::vector<std::uint64_t>& hashes, const std::vector<ValueType>& values) {
+			clear();
+
+			auto count = hashes.size();
+			if (count == 0) {
+				return true;
+			}
+			if (count >= direct_slot) {
+				return false;
+			}
+
+			auto bucket_count = count / average_bucket_size + 1;
+			std::vector<std::vector<std::uint32_t>> buckets(bucket_count);
+			for (std::size_t i = 0; i < count; ++i) {
+				buckets[_bucket_of(hashes[i], bucket_count)].push_back(std::uint32_t(i));
+			}
+
+			// Largest buckets first, they are hardest to place while the table is still empty.
+			std::vector<std::uint32_t> order(bucket_count);
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+				return buckets[lhs].size() > buckets[rhs].size();
+			});
+
+			std::vector<std::uint32_t> seeds(bucket_count, 0);
+			std::vector<bool> occupied(count, false);
+			std::vector<std::size_t> slots;
+
+			auto next_free = std::size_t(0);
+			for (auto bucket_index : order) {
+				const auto& bucket = buckets[bucket_index];
+				if (bucket.empty()) {
+					break;
+				}
+
+				if (bucket.size() == 1) {
+					// A single value can take any free slot, no seed needs to be searched.
+					while (occupied[next_free]) {
+						++next_free;
+					}
+					occupied[next_free] = true;
+					seeds[bucket_index] = direct_slot | std::uint32_t(next_free);
+					continue;
+				}
+
+				bool placed = false;
+				for (std::uint32_t seed = 0; seed < max_seed_attempts && !placed; ++seed) {
+					slots.clear();
+					placed = true;
+					for (auto i : bucket) {
+						auto slot = _slot_of(hashes[i], seed, count);
+						if (occupied[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+							placed = false;
+							break;
+						}
+						slots.push_back(slot);
+					}
+
+					if (placed) {
+						for (auto slot : slots) {
+							occupied[slot] = true;
+						}
+						seeds[bucket_index] = seed;
+					}
+				}
+
+				if (!placed) {
+					return false;
+				}
+			}
+
+			_values.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				_values[_slot_for(hashes[i], seeds, count)] = values[i];
+			}
+			_seeds = std::move(seeds);
+
+			return true;
+		}
+
+		void clear() {
+			_seeds = {};
+			_values = {};
+		}
+
+		bool empty() const {
+			return _values.empty();
+		}
+
+		std::size_t size() const {
+			return _values.size();
+		}
+
+		/// Returns the only value that can match hash, or nullptr if the table is empty.
+		const ValueType* lookup(std::uint64_t hash) const {
+			if (_values.empty()) {
+				return nullptr;
+			}
+			return &_values[_slot_for(hash, _seeds, _values.size())];
+		}
+
+	private:
+		static std::size_t _bucket_of(std::uint64_t hash, std::size_t bucket_count) {
+			return std::size_t(hash >> 32) % bucket_count;
+		}
+
+		static std::size_t _slot_of(std::uint64_t hash, std::uint32_t seed, std::size_t count) {
+			// murmur3 finalizer, mixes the seed into every bit before reducing.
+			auto h = hash ^ (std::uint64_t(seed) * 0x9e3779b97f4a7c15ull);
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+			return std::size_t(h % count);
+		}
+
+		static std::size_t _slot_for(std::uint64_t hash, const std::vector<std::uint32_t>& seeds, std::size_t count) {
+			auto seed = seeds[_bucket_of(hash, seeds.size())];
+			if (seed & direct_slot) {
+				return seed & ~direct_slot;
+			}
+			return _slot_of(hash, seed, count);
+		}
+
+		std::vector<std::uint32_t> _seeds;
+		std::vector<ValueType> _values;
+	};
+}
@@ -1,34 +1,116 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <istream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <ostream>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <openvic-dataloader/detail/HashAlgorithm.hpp>
 #include <openvic-dataloader/detail/HashTable.hpp>
 #include <openvic-dataloader/detail/MemoryResource.hpp>
+#include <openvic-dataloader/detail/PerfectHash.hpp>
 #include <openvic-dataloader/detail/Utility.hpp>
 #include <openvic-dataloader/detail/pinned_vector.hpp>
 
 namespace ovdl {
+	/// How a symbol_buffer stores its symbols.
+	enum class symbol_storage : std::uint8_t {
+		/// One contiguous pinned_vector, reserving address space for max_elements up front.
+		reserved,
+		/// Separately allocated fixed-size chunks, nothing is reserved up front.
+		chunked,
+	};
+
+	namespace detail {
+		inline std::atomic<symbol_storage> global_symbol_storage { symbol_storage::reserved };
+		inline thread_local std::optional<symbol_storage> scoped_symbol_storage;
+	}
+
+	/// Storage used by symbol buffers that are not given one explicitly.
+	inline symbol_storage default_symbol_storage() {
+		return detail::scoped_symbol_storage.value_or(detail::global_symbol_storage.load(std::memory_order_relaxed));
+	}
+
+	/// Changes the storage for all threads without a symbol_storage_scope, only affects buffers constructed afterwards.
+	inline void set_default_symbol_storage(symbol_storage storage) {
+		detail::global_symbol_storage.store(storage, std::memory_order_relaxed);
+	}
+
+	/// Overrides the default symbol storage on the current thread while alive, std::nullopt keeps the current default.
+	struct symbol_storage_scope {
+		explicit symbol_storage_scope(std::optional<symbol_storage> storage) : _previous(detail::scoped_symbol_storage) {
+			if (storage) {
+				detail::scoped_symbol_storage = storage;
+			}
+		}
+
+		~symbol_storage_scope() {
+			detail::scoped_symbol_storage = _previous;
+		}
+
+		symbol_storage_scope(const symbol_storage_scope&) = delete;
+		symbol_storage_scope& operator=(const symbol_storage_scope&) = delete;
+
+	private:
+		std::optional<symbol_storage> _previous;
+	};
+
 	// Contains all unique symbols, null-terminated, in memory one after the other.
+	//
+	// Symbols are addressed by offset. With chunked storage the offsets are virtual: the buffer is divided into
+	// chunk_size pages, a symbol never straddles an allocation and pages are mapped to their allocations, so
+	// c_str stays a single indexed load and returned pointers are stable.
 	template<typename CharT>
 	struct symbol_buffer {
 		static constexpr auto min_buffer_size = 16 * 1024;
+		static constexpr std::size_t chunk_size = min_buffer_size;
 
-		constexpr symbol_buffer() : _data_buffer(ovdl::detail::max_elements(min_buffer_size + 1)) {}
-		explicit symbol_buffer(std::size_t max_elements)
-			: _data_buffer(ovdl::detail::max_elements(std::max<std::size_t>(max_elements, min_buffer_size + 1))) {
-			_data_buffer.reserve(min_buffer_size);
+		symbol_buffer()
+			: _storage(default_symbol_storage()),
+			  _max_size(_storage == symbol_storage::chunked ? std::numeric_limits<std::size_t>::max() : min_buffer_size + 1) {
+			if (_storage == symbol_storage::reserved) {
+				_data_buffer = detail::pinned_vector<CharT>(ovdl::detail::max_elements(_max_size));
+			}
 		}
+		explicit symbol_buffer(std::size_t max_elements) : symbol_buffer(max_elements, default_symbol_storage()) {}
+		/// max_elements sizes the reservation of reserved storage, chunked storage grows without a bound.
+		symbol_buffer(std::size_t max_elements, symbol_storage storage)
+			: _storage(storage),
+			  _max_size(storage == symbol_storage::chunked ? std::numeric_limits<std::size_t>::max() : std::max<std::size_t>(max_elements, min_buffer_size + 1)) {
+			if (_storage == symbol_storage::reserved) {
+				_data_buffer = detail::pinned_vector<CharT>(ovdl::detail::max_elements(_max_size));
+				_data_buffer.reserve(min_buffer_size);
+			}
+		}
+
+		symbol_buffer(symbol_buffer&&) = default;
+		symbol_buffer& operator=(symbol_buffer&&) = default;
 
 		void free() {
 		}
 
+		symbol_storage storage() const {
+			return _storage;
+		}
+
 		bool reserve(std::size_t new_capacity) {
+			if (_storage == symbol_storage::chunked) {
+				// Chunks are allocated on demand.
+				return true;
+			}
+
 			if (new_capacity <= _data_buffer.capacity()) {
 				return true;
 			}
@@ -44,6 +126,11 @@ namespace ovdl {
 		}
 
 		bool reserve_new_string(std::size_t new_string_length) {
+			if (_storage == symbol_storage::chunked) {
+				// Chunks are allocated on demand, worst case the rest of the current chunk is skipped.
+				return new_string_length < _max_size - _size - chunk_size;
+			}
+
 			// +1 for null-terminator.
 			auto new_size = _data_buffer.size() + new_string_length + 1;
 			if (new_size <= _data_buffer.capacity()) {
@@ -62,41 +149,131 @@ namespace ovdl {
 			return true;
 		}
 
-		const CharT* insert(const CharT* str, std::size_t length) {
+		// Copies str into the buffer and returns the offset of its copy.
+		std::size_t append(const CharT* str, std::size_t length) {
+			if (_storage == symbol_storage::chunked) {
+				auto offset = _allocate_chunked(length + 1, false);
+				auto* data = _pages[offset / chunk_size] + offset % chunk_size;
+				std::memcpy(data, str, length * sizeof(CharT));
+				data[length] = CharT(0);
+				return offset;
+			}
+
 			assert(_data_buffer.capacity() - _data_buffer.size() >= length + 1);
 
-			auto index = _data_buffer.cend();
+			auto offset = _data_buffer.size();
 
 			_data_buffer.insert(_data_buffer.cend(), str, str + (length * sizeof(CharT)));
 			_data_buffer.push_back(CharT(0));
 
-			return index;
+			return offset;
+		}
+
+		const CharT* insert(const CharT* str, std::size_t length) {
+			return c_str(append(str, length));
+		}
+
+		// Appends size uninitialized characters and returns their start, or nullptr if they do not fit.
+		CharT* append_uninitialized(std::size_t size) {
+			if (_storage == symbol_storage::chunked) {
+				// Offsets stay contiguous only if the allocation starts at the current end.
+				if (size == 0 || size > _max_size - _size || (_size % chunk_size != 0 && !_fits_current_chunk(size))) {
+					return nullptr;
+				}
+				auto offset = _allocate_chunked(size, true);
+				return _pages[offset / chunk_size] + offset % chunk_size;
+			}
+
+			if (!reserve(_data_buffer.size() + size)) {
+				return nullptr;
+			}
+
+			auto index = _data_buffer.size();
+			_data_buffer.resize(index + size);
+			return _data_buffer.data() + index;
 		}
 
 		const CharT* c_str(std::size_t index) const {
-			assert(index < _data_buffer.size());
+			assert(index < size());
+			if (_storage == symbol_storage::chunked) {
+				return _pages[index / chunk_size] + index % chunk_size;
+			}
 			return _data_buffer.data() + index;
 		}
 
+		/// Calls callback(const CharT* data, std::size_t size) for consecutive pieces covering all offsets in order.
+		template<typename Callback>
+		void for_each_range(Callback&& callback) const {
+			if (_storage == symbol_storage::reserved) {
+				if (_data_buffer.size() > 0) {
+					callback(_data_buffer.data(), _data_buffer.size());
+				}
+				return;
+			}
+
+			for (std::size_t page = 0; page * chunk_size < _size; ++page) {
+				callback(static_cast<const CharT*>(_pages[page]), std::min(chunk_size, _size - page * chunk_size));
+			}
+		}
+
 		std::size_t size() const {
-			return _data_buffer.size();
+			return _storage == symbol_storage::chunked ? _size : _data_buffer.size();
 		}
 
 		std::size_t capacity() const {
-			return _data_buffer.capacity();
+			return _storage == symbol_storage::chunked ? _pages.size() * chunk_size : _data_buffer.capacity();
 		}
 
 		std::size_t max_size() const {
-			return _data_buffer.max_size();
+			return _storage == symbol_storage::chunked ? _max_size : _data_buffer.max_size();
 		}
 
 	private:
+		bool _fits_current_chunk(std::size_t size) const {
+			return _size + size <= _pages.size() * chunk_size;
+		}
+
+		// Returns the offset of size new characters, allocating pages as needed.
+		std::size_t _allocate_chunked(std::size_t size, bool uninitialized) {
+			if (!_fits_current_chunk(size)) {
+				// Skip the rest of the current page, an allocation always starts on a page boundary.
+				_size = _pages.size() * chunk_size;
+
+				auto page_count = (size + chunk_size - 1) / chunk_size;
+				auto allocation = uninitialized ? std::make_unique_for_overwrite<CharT[]>(page_count * chunk_size)
+												: std::make_unique<CharT[]>(page_count * chunk_size);
+				for (std::size_t page = 0; page < page_count; ++page) {
+					_pages.push_back(allocation.get() + page * chunk_size);
+				}
+				_chunks.push_back(std::move(allocation));
+			}
+
+			auto offset = _size;
+			_size += size;
+			return offset;
+		}
+
+		symbol_storage _storage;
+		std::size_t _max_size;
 		detail::pinned_vector<CharT> _data_buffer;
+
+		// Chunked storage only.
+		std::vector<std::unique_ptr<CharT[]>> _chunks;
+		std::vector<CharT*> _pages;
+		std::size_t _size = 0;
+	};
+
+	// Location of a symbol in its symbol_buffer, stored per handle.
+	template<typename IndexType>
+	struct symbol_entry {
+		IndexType offset;
+		IndexType length;
 	};
 
 	template<typename IndexType, typename CharT>
 	struct symbol_index_hash_traits {
 		const symbol_buffer<CharT>* buffer;
+		const symbol_entry<IndexType>* entries;
 
 		using value_type = IndexType;
 
@@ -117,13 +294,14 @@ namespace ovdl {
 			return entry == value;
 		}
 		bool is_equal(IndexType entry, string_view str) const {
-			auto existing_str = buffer->c_str(entry);
-			return std::strncmp(existing_str, str.ptr, str.length) == 0 && *(existing_str + str.length) == CharT(0);
+			auto existing = entries[entry];
+			return existing.length == str.length &&
+				   std::memcmp(buffer->c_str(existing.offset), str.ptr, str.length * sizeof(CharT)) == 0;
 		}
 
 		std::size_t hash(IndexType entry) const {
-			auto str = buffer->c_str(entry);
-			return detail::DefaultHash().hash_c_str(str).finish();
+			auto existing = entries[entry];
+			return hash(string_view { buffer->c_str(existing.offset), existing.length });
 		}
 		static constexpr std::size_t hash(string_view str) {
 			return detail::DefaultHash()
@@ -132,6 +310,106 @@ namespace ovdl {
 		}
 	};
 
+	// Indexes symbols by their ASCII case-folded contents, only the first spelling of each folded string is stored.
+	template<typename IndexType, typename CharT>
+	struct symbol_index_ci_hash_traits : symbol_index_hash_traits<IndexType, CharT> {
+		using base_traits = symbol_index_hash_traits<IndexType, CharT>;
+		using typename base_traits::string_view;
+
+		static constexpr CharT fold(CharT c) {
+			return (c >= CharT('A') && c <= CharT('Z')) ? CharT(c - CharT('A') + CharT('a')) : c;
+		}
+
+		using base_traits::is_equal;
+		bool is_equal(IndexType entry, string_view str) const {
+			auto existing = this->entries[entry];
+			if (existing.length != str.length) {
+				return false;
+			}
+
+			const CharT* data = this->buffer->c_str(existing.offset);
+			for (std::size_t i = 0; i < str.length; ++i) {
+				if (fold(data[i]) != fold(str.ptr[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::size_t hash(IndexType entry) const {
+			auto existing = this->entries[entry];
+			return hash(string_view { this->buffer->c_str(existing.offset), existing.length });
+		}
+		static constexpr std::size_t hash(string_view str) {
+			auto hash = detail::DefaultHash();
+			for (std::size_t i = 0; i < str.length; ++i) {
+				hash.hash_scalar(fold(str.ptr[i]));
+			}
+			return std::move(hash).finish();
+		}
+	};
+
+	/// Compact handle to an interned symbol.
+	///
+	/// Handles are dense: the n-th unique symbol of an interner gets the id n, so ids can be used
+	/// directly as indices into consumer lookup tables. Resolving a handle requires its interner.
+	template<typename IndexType = std::uint32_t>
+	struct symbol_handle {
+		static_assert(std::is_unsigned_v<IndexType>);
+
+		using index_type = IndexType;
+
+		constexpr symbol_handle() = default;
+		constexpr explicit symbol_handle(IndexType id) : _id(id) {}
+
+		constexpr explicit operator bool() const {
+			return _id != IndexType(-1);
+		}
+
+		constexpr IndexType id() const {
+			return _id;
+		}
+
+		template<typename Interner>
+		constexpr auto resolve(const Interner& interner) const {
+			return interner.resolve(*this);
+		}
+
+		template<typename Interner>
+		constexpr auto c_str(const Interner& interner) const {
+			return resolve(interner).c_str();
+		}
+
+		template<typename Interner>
+		constexpr auto view(const Interner& interner) const {
+			return resolve(interner).view();
+		}
+
+		//=== comparison ===//
+		friend constexpr bool operator==(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id == rhs._id;
+		}
+		friend constexpr bool operator!=(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id != rhs._id;
+		}
+
+		friend constexpr bool operator<(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id < rhs._id;
+		}
+		friend constexpr bool operator<=(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id <= rhs._id;
+		}
+		friend constexpr bool operator>(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id > rhs._id;
+		}
+		friend constexpr bool operator>=(symbol_handle lhs, symbol_handle rhs) {
+			return lhs._id >= rhs._id;
+		}
+
+	private:
+		IndexType _id = IndexType(-1);
+	};
+
 	template<typename CharT = char>
 	class symbol;
 
@@ -143,9 +421,11 @@ namespace ovdl {
 
 		using resource_ptr = detail::MemoryResourcePtr<MemoryResource>;
 		using traits = symbol_index_hash_traits<IndexType, CharT>;
+		using ci_traits = symbol_index_ci_hash_traits<IndexType, CharT>;
 
 	public:
 		using symbol = ovdl::symbol<CharT>;
+		using symbol_handle = ovdl::symbol_handle<IndexType>;
 
 		//=== construction ===//
 		constexpr symbol_interner() : _resource(detail::get_memory_resource<MemoryResource>()) {}
@@ -155,85 +435,494 @@ namespace ovdl {
 		constexpr explicit symbol_interner(std::size_t max_elements, MemoryResource* resource)
 			: _buffer(max_elements),
 			  _resource(resource) {}
+		constexpr symbol_interner(std::size_t max_elements, symbol_storage storage)
+			: _buffer(max_elements, storage),
+			  _resource(detail::get_memory_resource<MemoryResource>()) {}
+		constexpr symbol_interner(std::size_t max_elements, symbol_storage storage, MemoryResource* resource)
+			: _buffer(max_elements, storage),
+			  _resource(resource) {}
 
 		~symbol_interner() noexcept {
 			_buffer.free();
 			_map.free(_resource);
+			_ci_map.free(_resource);
 		}
 
 		symbol_interner(symbol_interner&& other) noexcept
-			: _buffer(other._buffer), _map(other._map), _resource(other._resource) {
+			: _buffer(std::move(other._buffer)), _entries(std::move(other._entries)), _map(other._map),
+			  _frozen_map(std::move(other._frozen_map)), _is_frozen(other._is_frozen),
+			  _ci_map(other._ci_map), _has_ci_index(other._has_ci_index), _resource(other._resource) {
 			other._buffer = {};
 			other._map = {};
+			other._is_frozen = false;
+			other._ci_map = {};
+			other._has_ci_index = false;
 		}
 
 		symbol_interner& operator=(symbol_interner&& other) noexcept {
 			std::swap(_buffer, other._buffer);
+			std::swap(_entries, other._entries);
 			std::swap(_map, other._map);
+			std::swap(_frozen_map, other._frozen_map);
+			std::swap(_is_frozen, other._is_frozen);
+			std::swap(_ci_map, other._ci_map);
+			std::swap(_has_ci_index, other._has_ci_index);
 			std::swap(_resource, other._resource);
 			return *this;
 		}
 
+		//=== freezing ===//
+		/// Replaces the growable hash table with a minimal perfect hash over all interned symbols.
+		///
+		/// Afterwards nothing new can be interned: intern only returns already interned symbols and an empty
+		/// symbol otherwise. As a frozen interner is never modified, lookups may run concurrently from any
+		/// number of threads. Returns false if no perfect hash could be built, the interner is unchanged then.
+		bool freeze() {
+			if (_is_frozen) {
+				return true;
+			}
+
+			std::vector<std::uint64_t> hashes;
+			std::vector<IndexType> ids;
+			hashes.reserve(_entries.size());
+			ids.reserve(_entries.size());
+			for (std::size_t id = 0; id < _entries.size(); ++id) {
+				hashes.push_back(_traits().hash(IndexType(id)));
+				ids.push_back(IndexType(id));
+			}
+
+			if (!_frozen_map.build(hashes, ids)) {
+				return false;
+			}
+
+			_map.free(_resource);
+			_entries.shrink_to_fit();
+			_is_frozen = true;
+			return true;
+		}
+
+		bool is_frozen() const {
+			return _is_frozen;
+		}
+
+		//=== case-insensitive lookup ===//
+		/// Maintains a second index keyed by ASCII case-folded contents from now on, including already interned symbols.
+		///
+		/// Every case-folded equivalence class is represented by its canonical symbol, the first one interned.
+		void enable_case_insensitive_index() {
+			if (_has_ci_index) {
+				return;
+			}
+
+			_has_ci_index = true;
+			_ci_map.rehash(_resource, _ci_map.to_table_capacity(_entries.size() * 2 + 1), _ci_traits());
+			for (std::size_t id = 0; id < _entries.size(); ++id) {
+				_index_case_insensitive(IndexType(id));
+			}
+		}
+
+		bool has_case_insensitive_index() const {
+			return _has_ci_index;
+		}
+
+		/// Returns the canonical symbol equal to str when ignoring ASCII case, requires the case-insensitive index.
+		symbol find_intern_ci(const CharT* str, std::size_t length) const {
+			return resolve(find_handle_ci(str, length));
+		}
+		template<std::size_t N>
+		symbol find_intern_ci(const CharT (&literal)[N]) const {
+			assert(literal[N - 1] == CharT(0));
+			return find_intern_ci(literal, N - 1);
+		}
+
+		symbol_handle find_handle_ci(const CharT* str, std::size_t length) const {
+			assert(_has_ci_index && "case-insensitive index is not enabled");
+			auto entry = _ci_map.lookup(typename ci_traits::string_view { str, length }, _ci_traits());
+			if (entry) {
+				return symbol_handle(*entry);
+			}
+
+			return symbol_handle();
+		}
+		template<std::size_t N>
+		symbol_handle find_handle_ci(const CharT (&literal)[N]) const {
+			assert(literal[N - 1] == CharT(0));
+			return find_handle_ci(literal, N - 1);
+		}
+
+		/// Returns the canonical handle of handle's case-folded equivalence class, requires the case-insensitive index.
+		symbol_handle canonical_handle(symbol_handle handle) const {
+			if (!handle) {
+				return handle;
+			}
+
+			auto entry = _entries[handle.id()];
+			return find_handle_ci(_buffer.c_str(entry.offset), entry.length);
+		}
+
+		//=== snapshots ===//
+		/// Writes all symbols in handle order, a snapshot restores identical handles.
+		///
+		/// Snapshots are a raw copy of the symbol buffer and entries, they are only readable by interners with the
+		/// same character type, index type and byte order.
+		bool write_snapshot(std::basic_ostream<char>& stream) const {
+			snapshot_header header {
+				.symbol_count = _entries.size(),
+				.buffer_size = _buffer.size(),
+			};
+
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char*>(_entries.data()), std::streamsize(_entries.size() * sizeof(symbol_entry<IndexType>)));
+			_buffer.for_each_range([&](const CharT* data, std::size_t size) {
+				stream.write(reinterpret_cast<const char*>(data), std::streamsize(size * sizeof(CharT)));
+			});
+			return bool(stream);
+		}
+
+		/// Restores a snapshot written by write_snapshot into this interner, which must be empty.
+		///
+		/// The restored interner is not frozen and keeps interning after the snapshot's symbols.
+		/// Returns false if the snapshot is invalid or does not fit, the interner is left empty then.
+		bool read_snapshot(std::basic_istream<char>& stream) {
+			assert(_entries.empty() && !_is_frozen && "snapshots can only be read into an empty interner");
+
+			snapshot_header header;
+			stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+			// Every symbol takes at least its null-terminator, so the buffer bounds the symbol count.
+			if (!stream || !header.is_compatible() || header.symbol_count > header.buffer_size ||
+				header.buffer_size > _buffer.max_size() || header.buffer_size != IndexType(header.buffer_size)) {
+				return false;
+			}
+
+			// A truncated or corrupt snapshot must fail instead of first allocating what its header claims. Seekable
+			// streams are checked against their remaining length, entries are read in bounded pieces regardless.
+			auto start = stream.tellg();
+			if (start != std::streampos(-1) && stream.seekg(0, std::ios_base::end)) {
+				auto remaining = std::uint64_t(stream.tellg() - start);
+				stream.seekg(start);
+				if (remaining / sizeof(symbol_entry<IndexType>) < header.symbol_count ||
+					(remaining - header.symbol_count * sizeof(symbol_entry<IndexType>)) / sizeof(CharT) < header.buffer_size) {
+					return false;
+				}
+			}
+			stream.clear(stream.rdstate() & ~std::ios_base::failbit);
+
+			static constexpr std::size_t entries_per_read = symbol_buffer<CharT>::chunk_size;
+			while (stream && _entries.size() < header.symbol_count) {
+				auto offset = _entries.size();
+				_entries.resize(offset + std::min<std::size_t>(entries_per_read, header.symbol_count - offset));
+				stream.read(reinterpret_cast<char*>(_entries.data() + offset), std::streamsize((_entries.size() - offset) * sizeof(symbol_entry<IndexType>)));
+			}
+			if (!stream) {
+				_reset();
+				return false;
+			}
+
+			CharT* data = header.buffer_size > 0 ? _buffer.append_uninitialized(header.buffer_size) : nullptr;
+			if (header.buffer_size > 0 && data == nullptr) {
+				_reset();
+				return false;
+			}
+			stream.read(reinterpret_cast<char*>(data), std::streamsize(header.buffer_size * sizeof(CharT)));
+
+			if (!stream || !_rebuild_map()) {
+				_reset();
+				return false;
+			}
+			return true;
+		}
+
 		//=== interning ===//
 		bool reserve(std::size_t number_of_symbols, std::size_t average_symbol_length) {
+			if (_is_frozen) {
+				return false;
+			}
+
 			auto success = _buffer.reserve(number_of_symbols * average_symbol_length);
-			_map.rehash(_resource, _map.to_table_capacity(number_of_symbols), traits { &_buffer });
+			_entries.reserve(number_of_symbols);
+			_map.rehash(_resource, _map.to_table_capacity(number_of_symbols), _traits());
 			return success;
 		}
 
-		symbol find_intern(const CharT* str, std::size_t length) {
-			if (_map.should_rehash()) {
-				return symbol();
+		symbol find_intern(const CharT* str, std::size_t length) const {
+			return resolve(find_handle(str, length));
+		}
+		template<std::size_t N>
+		symbol find_intern(const CharT (&literal)[N]) const {
+			assert(literal[N - 1] == CharT(0));
+			return find_intern(literal, N - 1);
+		}
+
+		symbol_handle find_handle(const CharT* str, std::size_t length) const {
+			typename traits::string_view key { str, length };
+			if (_is_frozen) {
+				auto candidate = _frozen_map.lookup(_traits().hash(key));
+				if (candidate && _traits().is_equal(*candidate, key)) {
+					return symbol_handle(*candidate);
+				}
+				return symbol_handle();
 			}
 
-			auto entry = _map.lookup_entry(typename traits::string_view { str, length }, traits { &_buffer });
+			auto entry = _map.lookup(key, _traits());
 			if (entry) {
-				return symbol(_buffer.c_str(entry.get()));
+				return symbol_handle(*entry);
 			}
 
-			return symbol();
+			return symbol_handle();
 		}
 		template<std::size_t N>
-		symbol find_intern(const CharT (&literal)[N]) {
+		symbol_handle find_handle(const CharT (&literal)[N]) const {
 			assert(literal[N - 1] == CharT(0));
-			return find_intern(literal, N - 1);
+			return find_handle(literal, N - 1);
 		}
 
 		symbol intern(const CharT* str, std::size_t length) {
+			return resolve(intern_handle(str, length));
+		}
+		template<std::size_t N>
+		symbol intern(const CharT (&literal)[N]) {
+			assert(literal[N - 1] == CharT(0));
+			return intern(literal, N - 1);
+		}
+
+		symbol_handle intern_handle(const CharT* str, std::size_t length) {
+			if (_is_frozen) {
+				return find_handle(str, length);
+			}
+
 			if (_map.should_rehash()) {
-				_map.rehash(_resource, traits { &_buffer });
+				_map.rehash(_resource, _traits());
 			}
 
-			auto entry = _map.lookup_entry(typename traits::string_view { str, length }, traits { &_buffer });
+			auto entry = _map.lookup_entry(typename traits::string_view { str, length }, _traits());
 			if (entry) {
-				// Already interned, return index.
-				return symbol(_buffer.c_str(entry.get()));
+				// Already interned, return handle.
+				return symbol_handle(entry.get());
+			}
+
+			return _insert(entry, str, length);
+		}
+		template<std::size_t N>
+		symbol_handle intern_handle(const CharT (&literal)[N]) {
+			assert(literal[N - 1] == CharT(0));
+			return intern_handle(literal, N - 1);
+		}
+
+		/// Interns every string of strings and writes its handle to the same index of handles.
+		///
+		/// Equivalent to calling intern_handle for each string in order, but hashes a batch of strings first
+		/// and prefetches their table entries so the probes of a batch overlap their cache misses.
+		/// Returns false if any string could not be interned, its handle is empty then.
+		bool intern_many(std::span<const std::basic_string_view<CharT>> strings, std::span<symbol_handle> handles) {
+			assert(strings.size() <= handles.size());
+
+			if (_is_frozen) {
+				bool result = true;
+				for (std::size_t i = 0; i < strings.size(); ++i) {
+					handles[i] = find_handle(strings[i].data(), strings[i].size());
+					result &= bool(handles[i]);
+				}
+				return result;
+			}
+
+			// Size for the worst case of all strings being new, the batches below never rehash.
+			_map.rehash(_resource, _map.to_table_capacity((_entries.size() + strings.size()) * 2 + 1), _traits());
+			// Exact reservations would reallocate every entry on each of many small batches, grow geometrically.
+			if (_entries.capacity() < _entries.size() + strings.size()) {
+				_entries.reserve(std::max(_entries.size() + strings.size(), 2 * _entries.capacity()));
+			}
+
+			static constexpr std::size_t batch_size = 16;
+			std::size_t hashes[batch_size];
+
+			bool result = true;
+			for (std::size_t begin = 0; begin < strings.size(); begin += batch_size) {
+				auto end = std::min(begin + batch_size, strings.size());
+
+				for (std::size_t i = begin; i < end; ++i) {
+					hashes[i - begin] = traits::hash({ strings[i].data(), strings[i].size() });
+					_map.prefetch(hashes[i - begin]);
+				}
+
+				for (std::size_t i = begin; i < end; ++i) {
+					typename traits::string_view key { strings[i].data(), strings[i].size() };
+					auto entry = _map.lookup_entry_hashed(key, hashes[i - begin], _traits());
+					handles[i] = entry ? symbol_handle(entry.get()) : _insert(entry, key.ptr, key.length);
+					result &= bool(handles[i]);
+				}
 			}
+			return result;
+		}
+
+		/// Same as the handle overload, resolving each handle into symbols.
+		bool intern_many(std::span<const std::basic_string_view<CharT>> strings, std::span<symbol> symbols) {
+			assert(strings.size() <= symbols.size());
 
+			std::vector<symbol_handle> handles(strings.size());
+			bool result = intern_many(strings, std::span<symbol_handle> { handles });
+			for (std::size_t i = 0; i < handles.size(); ++i) {
+				symbols[i] = resolve(handles[i]);
+			}
+			return result;
+		}
+
+		//=== access ===//
+		symbol resolve(symbol_handle handle) const {
+			if (!handle) {
+				return symbol();
+			}
+
+			assert(handle.id() < _entries.size());
+			auto entry = _entries[handle.id()];
+			return symbol(_buffer.c_str(entry.offset), entry.length);
+		}
+
+		/// Number of unique symbols, every valid handle's id is less than this.
+		std::size_t size() const {
+			return _entries.size();
+		}
+
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+		struct statistics {
+			std::size_t symbol_count = 0;
+			// Symbol contents including null-terminators.
+			std::size_t buffer_bytes = 0;
+			std::size_t buffer_capacity_bytes = 0;
+			// Size of the virtual memory reservation backing the buffer.
+			std::size_t buffer_max_bytes = 0;
+			std::size_t entry_bytes = 0;
+			// Empty once frozen.
+			detail::HashTableStatistics table;
+			detail::HashTableStatistics case_insensitive_table;
+		};
+
+		statistics compute_statistics() const {
+			statistics result {
+				.symbol_count = _entries.size(),
+				.buffer_bytes = _buffer.size() * sizeof(CharT),
+				.buffer_capacity_bytes = _buffer.capacity() * sizeof(CharT),
+				.buffer_max_bytes = _buffer.max_size() * sizeof(CharT),
+				.entry_bytes = _entries.size() * sizeof(symbol_entry<IndexType>),
+				.table = _map.compute_statistics(_traits()),
+			};
+
+			if (_has_ci_index) {
+				result.case_insensitive_table = _ci_map.compute_statistics(_ci_traits());
+			}
+			return result;
+		}
+#endif
+
+	private:
+		struct snapshot_header {
+			static constexpr std::uint64_t expected_magic = 0x4d59534c44564f; // "OVDLSYM"
+			static constexpr std::uint32_t expected_version = 1;
+
+			std::uint64_t magic = expected_magic;
+			std::uint32_t version = expected_version;
+			std::uint16_t char_size = sizeof(CharT);
+			std::uint16_t index_size = sizeof(IndexType);
+			std::uint64_t symbol_count = 0;
+			std::uint64_t buffer_size = 0;
+
+			// The magic doubles as byte order check.
+			bool is_compatible() const {
+				return magic == expected_magic && version == expected_version &&
+					   char_size == sizeof(CharT) && index_size == sizeof(IndexType);
+			}
+		};
+
+		traits _traits() const {
+			return traits { &_buffer, _entries.data() };
+		}
+
+		// Copies a string not yet interned into the buffer and stores its new handle in entry.
+		symbol_handle _insert(typename detail::HashTable<traits, 1024>::entry_handle entry, const CharT* str, std::size_t length) {
 			// Copy string data to buffer, as we don't have it yet.
 			if (!_buffer.reserve_new_string(length)) { // Ran out of virtual memory space
-				return symbol();
+				return symbol_handle();
 			}
+			// Chunked storage has no reservation to bound it, the offset must still fit IndexType.
+			if (_buffer.size() + symbol_buffer<CharT>::chunk_size + length >= std::size_t(IndexType(-1))) {
+				return symbol_handle();
+			}
+
+			auto offset = _buffer.append(str, length);
+			assert(std::size_t(offset) == IndexType(offset)); // Overflow of index type.
 
-			auto begin = _buffer.insert(str, length);
-			auto idx = std::distance(_buffer.c_str(0), begin);
-			assert(idx == IndexType(idx)); // Overflow of index type.
+			auto id = _entries.size();
+			assert(id < IndexType(-1)); // Overflow of index type.
+			_entries.push_back({ IndexType(offset), IndexType(length) });
 
-			// Store index in map.
-			entry.create(IndexType(idx));
+			// Store handle in map.
+			entry.create(IndexType(id));
+
+			if (_has_ci_index) {
+				_index_case_insensitive(IndexType(id));
+			}
 
-			// Return new symbol.
-			return symbol(begin);
+			// Return new handle.
+			return symbol_handle(IndexType(id));
 		}
-		template<std::size_t N>
-		symbol intern(const CharT (&literal)[N]) {
-			assert(literal[N - 1] == CharT(0));
-			return intern(literal, N - 1);
+
+		ci_traits _ci_traits() const {
+			return ci_traits { { &_buffer, _entries.data() } };
+		}
+
+		void _index_case_insensitive(IndexType id) {
+			if (_ci_map.should_rehash()) {
+				_ci_map.rehash(_resource, _ci_traits());
+			}
+
+			auto entry = _entries[id];
+			auto ci_entry = _ci_map.lookup_entry(typename ci_traits::string_view { _buffer.c_str(entry.offset), entry.length }, _ci_traits());
+			if (!ci_entry) {
+				ci_entry.create(id);
+			}
+		}
+
+		// Validates the entries against the buffer and indexes them, rejecting duplicates.
+		bool _rebuild_map() {
+			_map.rehash(_resource, _map.to_table_capacity(_entries.size() * 2 + 1), _traits());
+
+			for (std::size_t id = 0; id < _entries.size(); ++id) {
+				auto entry = _entries[id];
+				if (std::size_t(entry.offset) + entry.length >= _buffer.size() ||
+					_buffer.c_str(entry.offset)[entry.length] != CharT(0)) {
+					return false;
+				}
+
+				if (_map.should_rehash()) {
+					_map.rehash(_resource, _traits());
+				}
+
+				auto slot = _map.lookup_entry(typename traits::string_view { _buffer.c_str(entry.offset), entry.length }, _traits());
+				if (slot) {
+					return false;
+				}
+				slot.create(IndexType(id));
+
+				if (_has_ci_index) {
+					_index_case_insensitive(IndexType(id));
+				}
+			}
+			return true;
+		}
+
+		void _reset() {
+			_map.free(_resource);
+			_ci_map.free(_resource);
+			_entries.clear();
+			_buffer = symbol_buffer<CharT>(_buffer.max_size(), _buffer.storage());
 		}
 
-	private:
 		symbol_buffer<CharT> _buffer;
+		std::vector<symbol_entry<IndexType>> _entries;
 		detail::HashTable<traits, 1024> _map;
+		detail::PerfectHashTable<IndexType> _frozen_map;
+		bool _is_frozen = false;
+		detail::HashTable<ci_traits, 1024> _ci_map;
+		bool _has_ci_index = false;
 		OVDL_NO_UNIQUE_ADDRESS resource_ptr _resource;
 
 		friend symbol;
@@ -244,7 +933,12 @@ namespace ovdl {
 		using char_type = CharT;
 
 		constexpr symbol() = default;
-		constexpr explicit symbol(const CharT* begin) : _begin(begin) {}
+		constexpr explicit symbol(const CharT* begin)
+			: _begin(begin),
+			  _length(begin ? std::char_traits<CharT>::length(begin) : 0) {}
+		constexpr explicit symbol(const CharT* begin, std::size_t length)
+			: _begin(begin),
+			  _length(length) {}
 
 		constexpr explicit operator bool() const {
 			return _begin != nullptr;
@@ -255,7 +949,11 @@ namespace ovdl {
 		}
 
 		constexpr const std::basic_string_view<CharT> view() const {
-			return _begin;
+			return { _begin, _length };
+		}
+
+		constexpr std::size_t size() const {
+			return _length;
 		}
 
 		//=== comparison ===//
@@ -281,6 +979,7 @@ namespace ovdl {
 
 	private:
 		const CharT* _begin = nullptr;
+		std::size_t _length = 0;
 
 		template<typename, typename, typename, typename>
 		friend class symbol_interner;
@@ -290,6 +989,7 @@ namespace ovdl {
 		struct SymbolId;
 		using index_type = std::uint32_t;
 		using symbol_type = symbol<char>;
+		using symbol_handle_type = symbol_handle<index_type>;
 		using symbol_interner_type = symbol_interner<SymbolId, symbol_type::char_type, index_type>;
 	};
 }
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/detail/Utility.hpp>
+
+namespace ovdl {
+	/// Open addressing hash map keyed by interned symbol handles.
+	///
+	/// Keys are hashed by handle id, never by string contents, and entries are stored inline in a single
+	/// array probed linearly. Handles of different interners must not be mixed in one map.
+	/// T must be default constructible, empty slots hold a default constructed value.
+	template<typename T, typename IndexType = SymbolIntern::index_type>
+	class symbol_map {
+		static constexpr std::size_t min_capacity = 16;
+
+	public:
+		using key_type = symbol_handle<IndexType>;
+		using mapped_type = T;
+
+		struct entry {
+			key_type key;
+			OVDL_NO_UNIQUE_ADDRESS T value;
+		};
+
+		template<bool Const>
+		class basic_iterator {
+			using entry_type = std::conditional_t<Const, const entry, entry>;
+
+		public:
+			using value_type = entry;
+			using reference = entry_type&;
+			using pointer = entry_type*;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			basic_iterator() = default;
+
+			reference operator*() const {
+				return *_current;
+			}
+			pointer operator->() const {
+				return _current;
+			}
+
+			basic_iterator& operator++() {
+				++_current;
+				_skip_empty();
+				return *this;
+			}
+			basic_iterator operator++(int) {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) {
+				return lhs._current == rhs._current;
+			}
+			friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) {
+				return lhs._current != rhs._current;
+			}
+
+		private:
+			basic_iterator(entry_type* current, entry_type* end) : _current(current), _end(end) {
+				_skip_empty();
+			}
+
+			void _skip_empty() {
+				while (_current != _end && !_current->key) {
+					++_current;
+				}
+			}
+
+			entry_type* _current = nullptr;
+			entry_type* _end = nullptr;
+
+			friend class symbol_map;
+		};
+
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+
+		symbol_map() = default;
+		explicit symbol_map(std::size_t expected_size) {
+			reserve(expected_size);
+		}
+
+		//=== lookup ===//
+		T* find(key_type key) {
+			auto index = _find_index(key);
+			return index != npos ? &_entries[index].value : nullptr;
+		}
+		const T* find(key_type key) const {
+			auto index = _find_index(key);
+			return index != npos ? &_entries[index].value : nullptr;
+		}
+
+		bool contains(key_type key) const {
+			return _find_index(key) != npos;
+		}
+
+		//=== modification ===//
+		/// Inserts value for key unless key is present, returns the stored value and whether it was inserted.
+		template<typename... Args>
+		std::pair<T*, bool> try_emplace(key_type key, Args&&... args) {
+			assert(key && "invalid handles cannot be keys");
+			if (_should_grow()) {
+				_rehash(_entries.empty() ? min_capacity : _entries.size() * 2);
+			}
+
+			auto index = _home_of(key);
+			while (_entries[index].key) {
+				if (_entries[index].key == key) {
+					return { &_entries[index].value, false };
+				}
+				index = (index + 1) & _mask();
+			}
+
+			_entries[index] = entry { key, T(std::forward<Args>(args)...) };
+			++_size;
+			return { &_entries[index].value, true };
+		}
+
+		std::pair<T*, bool> insert(key_type key, T value) {
+			return try_emplace(key, std::move(value));
+		}
+
+		T& operator[](key_type key) {
+			return *try_emplace(key).first;
+		}
+
+		bool erase(key_type key) {
+			auto index = _find_index(key);
+			if (index == npos) {
+				return false;
+			}
+
+			// Backward shift deletion keeps probe sequences intact without tombstones.
+			auto next = (index + 1) & _mask();
+			while (_entries[next].key) {
+				auto home = _home_of(_entries[next].key);
+				if (((next - home) & _mask()) >= ((next - index) & _mask())) {
+					_entries[index] = std::move(_entries[next]);
+					index = next;
+				}
+				next = (next + 1) & _mask();
+			}
+			_entries[index] = entry {};
+			--_size;
+			return true;
+		}
+
+		void clear() {
+			for (auto& slot : _entries) {
+				slot = entry {};
+			}
+			_size = 0;
+		}
+
+		void reserve(std::size_t expected_size) {
+			// Stays at most half full.
+			auto capacity = std::bit_ceil(std::max(expected_size * 2, min_capacity));
+			if (capacity > _entries.size()) {
+				_rehash(capacity);
+			}
+		}
+
+		//=== access ===//
+		std::size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		std::size_t capacity() const {
+			return _entries.size();
+		}
+
+		iterator begin() {
+			return { _entries.data(), _entries.data() + _entries.size() };
+		}
+		iterator end() {
+			return { _entries.data() + _entries.size(), _entries.data() + _entries.size() };
+		}
+		const_iterator begin() const {
+			return { _entries.data(), _entries.data() + _entries.size() };
+		}
+		const_iterator end() const {
+			return { _entries.data() + _entries.size(), _entries.data() + _entries.size() };
+		}
+
+	private:
+		static constexpr std::size_t npos = std::size_t(-1);
+
+		std::size_t _mask() const {
+			return _entries.size() - 1;
+		}
+
+		// Fibonacci hashing spreads dense and shard-tagged ids alike over the table.
+		std::size_t _home_of(key_type key) const {
+			auto shift = 64 - std::countr_zero(_entries.size());
+			return std::size_t((std::uint64_t(key.id()) * 11400714819323198485ull) >> shift);
+		}
+
+		bool _should_grow() const {
+			return (_size + 1) * 2 > _entries.size();
+		}
+
+		std::size_t _find_index(key_type key) const {
+			if (_size == 0 || !key) {
+				return npos;
+			}
+
+			for (auto index = _home_of(key);; index = (index + 1) & _mask()) {
+				if (_entries[index].key == key) {
+					return index;
+				}
+				if (!_entries[index].key) {
+					return npos;
+				}
+			}
+		}
+
+		void _rehash(std::size_t capacity) {
+			assert(std::has_single_bit(capacity));
+			auto old_entries = std::exchange(_entries, std::vector<entry>(capacity));
+			for (auto& slot : old_entries) {
+				if (!slot.key) {
+					continue;
+				}
+
+				auto index = _home_of(slot.key);
+				while (_entries[index].key) {
+					index = (index + 1) & _mask();
+				}
+				_entries[index] = std::move(slot);
+			}
+		}
+
+		std::vector<entry> _entries;
+		std::size_t _size = 0;
+	};
+
+	/// Open addressing hash set of interned symbol handles, see symbol_map.
+	template<typename IndexType = SymbolIntern::index_type>
+	class symbol_set {
+		struct empty {};
+		using map_type = symbol_map<empty, IndexType>;
+
+	public:
+		using key_type = typename map_type::key_type;
+
+		symbol_set() = default;
+		explicit symbol_set(std::size_t expected_size) : _map(expected_size) {}
+
+		bool contains(key_type key) const {
+			return _map.contains(key);
+		}
+
+		/// Returns whether key was inserted.
+		bool insert(key_type key) {
+			return _map.try_emplace(key).second;
+		}
+
+		bool erase(key_type key) {
+			return _map.erase(key);
+		}
+
+		void clear() {
+			_map.clear();
+		}
+
+		void reserve(std::size_t expected_size) {
+			_map.reserve(expected_size);
+		}
+
+		std::size_t size() const {
+			return _map.size();
+		}
+
+		bool empty() const {
+			return _map.empty();
+		}
+
+		template<typename Callback>
+		void for_each(Callback&& callback) const {
+			for (const auto& entry : _map) {
+				callback(entry.key);
+			}
+		}
+
+	private:
+		map_type _map;
+	};
+}
@@ -52,6 +52,15 @@ namespace ovdl::detail {
 #endif
 	}
 
+	/// Hints that ptr will be read soon, does nothing on compilers without a prefetch builtin.
+	inline void prefetch(const void* ptr) {
+#ifdef __GNUC__ // GCC, Clang, ICC
+		__builtin_prefetch(ptr);
+#else
+		(void)ptr;
+#endif
+	}
+
 	template<typename EnumT>
 		requires std::is_enum_v<EnumT>
 	constexpr std::underlying_type_t<EnumT> to_underlying(EnumT e) {
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ovdl::detail {
+	/// Called once per task index, context is passed through unchanged.
+	using work_stealing_task_fn = void (*)(void* context, std::size_t task);
+
+	/// Runs task for every index in [0, task_count) on up to thread_count threads, the calling thread included.
+	///
+	/// Every thread starts on its own contiguous share of the indices and takes them from the front. A thread
+	/// that runs out steals the back half of the largest remaining share, so uneven tasks still balance out.
+	/// Returns once every task has finished. thread_count 0 uses std::thread::hardware_concurrency.
+	void run_work_stealing(std::size_t task_count, std::size_t thread_count, work_stealing_task_fn task, void* context);
+}
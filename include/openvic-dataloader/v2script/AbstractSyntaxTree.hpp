@@ -1,8 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string_view>
 
 #include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/NumericText.hpp>
 #include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/detail/Utility.hpp>
 
@@ -62,39 +69,223 @@ namespace ovdl::v2script::ast {
 
 	struct ListValue;
 
+	/// An unlinked node list counting the nodes the grammar's list sinks push into it, so list nodes are
+	/// constructed with their statement count without walking the list again.
+	template<typename T>
+	struct CountedNodeList : dryad::unlinked_node_list<T> {
+		using base_type = dryad::unlinked_node_list<T>;
+
+		void push_back(T* node) {
+			base_type::push_back(node);
+			++_count;
+		}
+
+		void push_front(T* node) {
+			base_type::push_front(node);
+			++_count;
+		}
+
+		void append(CountedNodeList&& other) {
+			for (auto it = other.begin(); it != other.end();) {
+				// Advanced before the node is relinked into this list.
+				auto* node = *it;
+				++it;
+				push_back(node);
+			}
+		}
+
+		std::uint32_t count() const {
+			return _count;
+		}
+
+	private:
+		std::uint32_t _count = 0;
+	};
+
 	struct Statement;
-	using StatementList = dryad::unlinked_node_list<Statement>;
+	using StatementList = CountedNodeList<Statement>;
 
 	struct EventStatement;
 	using EventStatementList = dryad::unlinked_node_list<EventStatement>;
 
 	struct AssignStatement;
-	using AssignStatementList = dryad::unlinked_node_list<AssignStatement>;
+	using AssignStatementList = CountedNodeList<AssignStatement>;
 
-	struct Value : dryad::abstract_node_range<Node, NodeKind::FirstValue, NodeKind::LastValue> {
+	struct Value : dryad::abstract_node_range<Node, NodeKind::FirstValue, NodeKind::LastValue>, LocationSlot {
 		DRYAD_ABSTRACT_NODE_CTOR(Value);
 	};
 
+	/// What the text of a flat value looks like, decided when the value is created.
+	enum class FlatValueClass : std::uint8_t {
+		Word,
+		Integer, // -3
+		Decimal, // 0.25
+		Date,	 // 1836.1.1
+	};
+
+	constexpr FlatValueClass classify_flat_value(std::string_view text) {
+		if (detail::is_integer_text(text)) {
+			return FlatValueClass::Integer;
+		}
+		if (detail::is_decimal_text(text)) {
+			return FlatValueClass::Decimal;
+		}
+		if (detail::is_date_text(text)) {
+			return FlatValueClass::Date;
+		}
+		return FlatValueClass::Word;
+	}
+
+	using FlatDate = detail::date_parts;
+
 	struct FlatValue : dryad::abstract_node_range<Value, NodeKind::FirstFlatValue, NodeKind::LastFlatValue> {
-		SymbolIntern::symbol_type value() const {
-			return _value;
+		/// symbols is anything resolving the node's handle, an interner or the tree that created the node.
+		template<typename SymbolResolver>
+		SymbolIntern::symbol_type value(const SymbolResolver& symbols) const {
+			return symbols.resolve(_handle);
+		}
+
+		SymbolIntern::symbol_handle_type handle() const {
+			return _handle;
+		}
+
+		FlatValueClass value_class() const {
+			return _value_class;
+		}
+
+		bool is_number() const {
+			return _value_class == FlatValueClass::Integer || _value_class == FlatValueClass::Decimal;
+		}
+
+		/// Typed accessors decode the text on first use and cache the result in the node, they are empty when
+		/// value_class does not match or the value overflows. Safe to call from several threads at once.
+		template<typename SymbolResolver>
+		std::optional<std::int64_t> as_integer(const SymbolResolver& symbols) const {
+			if (_value_class != FlatValueClass::Integer) {
+				return std::nullopt;
+			}
+			auto payload = _decoded_payload(symbols);
+			return payload ? std::optional(std::bit_cast<std::int64_t>(*payload)) : std::nullopt;
+		}
+
+		/// Integers convert to double as well.
+		template<typename SymbolResolver>
+		std::optional<double> as_decimal(const SymbolResolver& symbols) const {
+			if (_value_class == FlatValueClass::Integer) {
+				auto integer = as_integer(symbols);
+				return integer ? std::optional(double(*integer)) : std::nullopt;
+			}
+			if (_value_class != FlatValueClass::Decimal) {
+				return std::nullopt;
+			}
+			auto payload = _decoded_payload(symbols);
+			return payload ? std::optional(std::bit_cast<double>(*payload)) : std::nullopt;
+		}
+
+		/// Exact signed fixed-point value with fractional_bits fractional bits, see detail::parse_fixed_point_text.
+		/// Integers shift their cached value, decimals are parsed from the text on every call since the cache word
+		/// holds their double, callers reading a decimal repeatedly should keep the result.
+		template<typename SymbolResolver>
+		std::optional<std::int64_t> as_fixed_point(const SymbolResolver& symbols, unsigned fractional_bits) const {
+			if (_value_class == FlatValueClass::Integer) {
+				// Reuses the cached integer, shifting it as long as it fits.
+				auto integer = as_integer(symbols);
+				if (!integer || fractional_bits > 62) {
+					return std::nullopt;
+				}
+				auto limit = std::numeric_limits<std::int64_t>::max() >> fractional_bits;
+				if (*integer > limit || *integer < -limit) {
+					return std::nullopt;
+				}
+				return *integer * (std::int64_t(1) << fractional_bits);
+			}
+			if (_value_class != FlatValueClass::Decimal) {
+				return std::nullopt;
+			}
+			return detail::parse_fixed_point_text(value(symbols).view(), fractional_bits);
+		}
+
+		template<typename SymbolResolver>
+		std::optional<FlatDate> as_date(const SymbolResolver& symbols) const {
+			if (_value_class != FlatValueClass::Date) {
+				return std::nullopt;
+			}
+			auto payload = _decoded_payload(symbols);
+			if (!payload) {
+				return std::nullopt;
+			}
+			return FlatDate { std::int32_t(*payload >> 16), std::uint8_t(*payload >> 8), std::uint8_t(*payload) };
 		}
 
 	protected:
-		explicit FlatValue(dryad::node_ctor ctor, NodeKind kind, SymbolIntern::symbol_type value)
+		explicit FlatValue(dryad::node_ctor ctor, NodeKind kind, SymbolIntern::symbol_handle_type handle, FlatValueClass value_class)
 			: node_base(ctor, kind),
-			  _value(value) {}
+			  _handle(handle),
+			  _value_class(value_class) {}
 
 	protected:
-		SymbolIntern::symbol_type _value;
+		SymbolIntern::symbol_handle_type _handle;
+		FlatValueClass _value_class;
+
+	private:
+		// The cache is one word: a decoded payload or one of two quiet NaN patterns marking it pending or invalid.
+		// Decimals never decode to those NaNs and dates use 48 bits, an integer equal to one is just not cached.
+		static constexpr std::uint64_t payload_pending = 0x7FF8'0000'0000'0001ull;
+		static constexpr std::uint64_t payload_invalid = 0x7FF8'0000'0000'0002ull;
+
+		template<typename SymbolResolver>
+		std::optional<std::uint64_t> _decoded_payload(const SymbolResolver& symbols) const {
+			// The word carries everything, racing threads decode the same text to the same payload.
+			auto payload = _payload.load(std::memory_order_relaxed);
+			if (payload == payload_invalid) {
+				return std::nullopt;
+			}
+			if (payload != payload_pending) {
+				return payload;
+			}
+
+			auto decoded = _decode(value(symbols).view());
+			if (!decoded) {
+				_payload.store(payload_invalid, std::memory_order_relaxed);
+			} else if (*decoded != payload_pending && *decoded != payload_invalid) {
+				_payload.store(*decoded, std::memory_order_relaxed);
+			}
+			return decoded;
+		}
+
+		std::optional<std::uint64_t> _decode(std::string_view text) const {
+			switch (_value_class) {
+				case FlatValueClass::Integer:
+					if (auto integer = detail::parse_integer_text(text)) {
+						return std::bit_cast<std::uint64_t>(*integer);
+					}
+					return std::nullopt;
+				case FlatValueClass::Decimal:
+					if (auto decimal = detail::parse_decimal_text(text)) {
+						return std::bit_cast<std::uint64_t>(*decimal);
+					}
+					return std::nullopt;
+				case FlatValueClass::Date:
+					if (auto date = detail::parse_date_text(text)) {
+						return (std::uint64_t(std::uint32_t(date->year)) << 16) | (std::uint64_t(date->month) << 8) | date->day;
+					}
+					return std::nullopt;
+				default:
+					return std::nullopt;
+			}
+		}
+
+		mutable std::atomic<std::uint64_t> _payload = payload_pending;
 	};
 
 	struct IdentifierValue : dryad::basic_node<NodeKind::IdentifierValue, FlatValue> {
-		explicit IdentifierValue(dryad::node_ctor ctor, SymbolIntern::symbol_type value) : node_base(ctor, value) {}
+		explicit IdentifierValue(dryad::node_ctor ctor, SymbolIntern::symbol_handle_type handle, FlatValueClass value_class = FlatValueClass::Word)
+			: node_base(ctor, handle, value_class) {}
 	};
 
 	struct StringValue : dryad::basic_node<NodeKind::StringValue, FlatValue> {
-		explicit StringValue(dryad::node_ctor ctor, SymbolIntern::symbol_type value) : node_base(ctor, value) {}
+		explicit StringValue(dryad::node_ctor ctor, SymbolIntern::symbol_handle_type handle, FlatValueClass value_class = FlatValueClass::Word)
+			: node_base(ctor, handle, value_class) {}
 	};
 
 	struct ListValue : dryad::basic_node<NodeKind::ListValue, dryad::container_node<Value>> {
@@ -104,15 +295,21 @@ namespace ovdl::v2script::ast {
 
 		DRYAD_CHILD_NODE_RANGE_GETTER(Statement, statements, nullptr, this->node_after(_last_statement));
 
+		/// Number of statements, recorded at construction.
+		std::size_t statement_count() const {
+			return _statement_count;
+		}
+
 	private:
 		Node* _last_statement;
+		std::uint32_t _statement_count = 0;
 	};
 
 	struct NullValue : dryad::basic_node<NodeKind::NullValue, Value> {
 		explicit NullValue(dryad::node_ctor ctor) : node_base(ctor) {}
 	};
 
-	struct Statement : dryad::abstract_node_range<dryad::container_node<Node>, NodeKind::FirstStatement, NodeKind::LastStatement> {
+	struct Statement : dryad::abstract_node_range<dryad::container_node<Node>, NodeKind::FirstStatement, NodeKind::LastStatement>, LocationSlot {
 		explicit Statement(dryad::node_ctor ctor, NodeKind kind, Value* right)
 			: node_base(ctor, kind) {
 			insert_child_after(nullptr, right);
@@ -154,14 +351,34 @@ namespace ovdl::v2script::ast {
 		DRYAD_CHILD_NODE_GETTER(Value, value, nullptr);
 	};
 
-	struct FileTree : dryad::basic_node<NodeKind::FileTree, dryad::container_node<Node>> {
+	struct FileTree : dryad::basic_node<NodeKind::FileTree, dryad::container_node<Node>>, LocationSlot {
 		explicit FileTree(dryad::node_ctor ctor, StatementList statements);
 		explicit FileTree(dryad::node_ctor ctor, AssignStatementList statements);
 		explicit FileTree(dryad::node_ctor ctor);
 
 		DRYAD_CHILD_NODE_RANGE_GETTER(Statement, statements, nullptr, this->node_after(_last_node));
 
+		/// Number of statements, recorded at construction.
+		std::size_t statement_count() const {
+			return _statement_count;
+		}
+
 	private:
 		Node* _last_node;
+		std::uint32_t _statement_count = 0;
 	};
+
+	/// Every v2script node kind carries a LocationSlot.
+	inline const LocationSlot* location_slot(const Node* node) {
+		if (auto* value = dryad::node_try_cast<Value>(node)) {
+			return value;
+		}
+		if (auto* statement = dryad::node_try_cast<Statement>(node)) {
+			return statement;
+		}
+		if (auto* file_tree = dryad::node_try_cast<FileTree>(node)) {
+			return file_tree;
+		}
+		return nullptr;
+	}
 }
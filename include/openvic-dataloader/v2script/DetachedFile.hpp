@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script {
+	namespace ast {
+		struct FileAbstractSyntaxTree;
+	}
+
+	/// A parsed file taken out of its Parser with Parser::detach.
+	///
+	/// Owns the tree, the symbols unless they were interned into a shared interner, and the node locations
+	/// as buffer offsets. The source buffer, error trees and parser state are gone, positions resolve through
+	/// a line index that kept only the line starts and where the buffer had multibyte characters.
+	class DetachedFile {
+	public:
+		DetachedFile();
+
+		DetachedFile(DetachedFile&&);
+		DetachedFile& operator=(DetachedFile&&);
+
+		~DetachedFile();
+
+		/// False when detached from a parser that had no parsed file.
+		bool has_file_node() const;
+
+		std::string_view get_file_path() const;
+
+		const ast::FileTree* get_file_node() const;
+
+		std::string_view value(const ast::FlatValue* node) const;
+		SymbolIntern::symbol_handle_type find_handle(std::string_view string) const;
+		/// The sequential interner the file interned into, must not be called when it used a concurrent one.
+		const SymbolIntern::symbol_interner_type& symbol_interner() const;
+		SymbolResolver symbol_resolver() const;
+
+		/// See Parser::statement_array.
+		std::span<const ast::Statement* const> statement_array(const ast::Node* list) const;
+
+		/// See Parser::find and Parser::find_all.
+		const ast::AssignStatement* find(const ast::Node* list, SymbolIntern::symbol_handle_type key) const;
+		const ast::AssignStatement* find(const ast::Node* list, std::string_view key) const;
+		std::span<const ast::AssignStatement* const> find_all(const ast::Node* list, SymbolIntern::symbol_handle_type key) const;
+		std::span<const ast::AssignStatement* const> find_all(const ast::Node* list, std::string_view key) const;
+
+		const FilePosition get_position(const ast::Node* node) const;
+
+	private:
+		struct Data;
+		std::unique_ptr<Data> _data;
+
+		DetachedFile(ast::FileAbstractSyntaxTree&& ast, std::string_view path);
+
+		friend class Parser;
+	};
+}
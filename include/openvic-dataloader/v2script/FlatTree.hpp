@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script::ast {
+	/// Compact record of one node in a FlatTree.
+	struct FlatNode {
+		NodeKind kind;
+		/// Only set for EventStatement.
+		bool is_province_event = false;
+		/// Only valid for FlatValue kinds.
+		SymbolIntern::symbol_handle_type handle;
+		/// Number of records in this node's subtree, including itself.
+		std::uint32_t subtree_size = 1;
+
+		bool is_flat_value() const {
+			return kind >= NodeKind::FirstFlatValue && kind <= NodeKind::LastFlatValue;
+		}
+
+		bool is_statement() const {
+			return kind >= NodeKind::FirstStatement && kind <= NodeKind::LastStatement;
+		}
+
+		template<typename SymbolResolver>
+		SymbolIntern::symbol_type value(const SymbolResolver& symbols) const {
+			return symbols.resolve(handle);
+		}
+	};
+
+	/// Read-only preorder array of a v2script tree.
+	///
+	/// Every node is a FlatNode record placed directly before its children, so a node's subtree is the contiguous
+	/// index range [index, index + subtree_size) and its next sibling starts right after it. Read-only passes can
+	/// iterate the records linearly instead of chasing node pointers. Node pointers are kept in a separate array
+	/// for looking up locations and other per-node data.
+	struct FlatTree {
+		using index_type = std::uint32_t;
+
+		class child_range {
+		public:
+			class iterator {
+			public:
+				using value_type = index_type;
+				using reference = index_type;
+				using difference_type = std::ptrdiff_t;
+				using iterator_category = std::forward_iterator_tag;
+
+				iterator() = default;
+
+				index_type operator*() const {
+					return _index;
+				}
+
+				iterator& operator++() {
+					_index = _tree->next_sibling(_index);
+					return *this;
+				}
+				iterator operator++(int) {
+					auto copy = *this;
+					++*this;
+					return copy;
+				}
+
+				friend bool operator==(const iterator& lhs, const iterator& rhs) {
+					return lhs._index == rhs._index;
+				}
+				friend bool operator!=(const iterator& lhs, const iterator& rhs) {
+					return lhs._index != rhs._index;
+				}
+
+			private:
+				iterator(const FlatTree* tree, index_type index) : _tree(tree), _index(index) {}
+
+				const FlatTree* _tree = nullptr;
+				index_type _index = 0;
+
+				friend class child_range;
+			};
+
+			iterator begin() const {
+				return { _tree, _begin };
+			}
+			iterator end() const {
+				return { _tree, _end };
+			}
+
+			bool empty() const {
+				return _begin == _end;
+			}
+
+		private:
+			child_range(const FlatTree* tree, index_type begin, index_type end) : _tree(tree), _begin(begin), _end(end) {}
+
+			const FlatTree* _tree;
+			index_type _begin;
+			index_type _end;
+
+			friend struct FlatTree;
+		};
+
+		/// Appends records in preorder, for producing a FlatTree without building a node tree first.
+		class Builder {
+		public:
+			/// Opens a node whose children follow until the matching close.
+			void open(NodeKind kind, const Node* source = nullptr, bool is_province_event = false);
+			void close();
+			void leaf(NodeKind kind, SymbolIntern::symbol_handle_type handle = {}, const Node* source = nullptr);
+
+			FlatTree finish() &&;
+
+		private:
+			std::vector<FlatNode> _nodes;
+			std::vector<const Node*> _sources;
+			std::vector<index_type> _open;
+		};
+
+		FlatTree() = default;
+
+		/// Flattens the subtree of root, which may be nullptr.
+		explicit FlatTree(const Node* root);
+
+		std::size_t size() const {
+			return _nodes.size();
+		}
+
+		bool empty() const {
+			return _nodes.empty();
+		}
+
+		const FlatNode& operator[](index_type index) const {
+			return _nodes[index];
+		}
+
+		auto begin() const {
+			return _nodes.begin();
+		}
+		auto end() const {
+			return _nodes.end();
+		}
+
+		/// The tree node a record was made from, nullptr for records produced without one.
+		const Node* source(index_type index) const {
+			return _sources[index];
+		}
+
+		index_type next_sibling(index_type index) const {
+			return index + _nodes[index].subtree_size;
+		}
+
+		child_range children(index_type index) const {
+			return { this, index + 1, next_sibling(index) };
+		}
+
+	private:
+		std::vector<FlatNode> _nodes;
+		std::vector<const Node*> _sources;
+	};
+}
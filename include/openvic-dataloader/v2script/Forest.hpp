@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script {
+	struct ForestData;
+
+	/// Nodes, symbols and locations of many parsed files in one shared arena, interner and location table.
+	///
+	/// Parsers constructed with a forest create their nodes in it, every successful parse adds the file's root.
+	/// Roots, values and positions stay available after the parsers and their buffers are gone, per file only
+	/// the root, path and line starts are kept. Only one parser may parse into a forest at a time, nodes of a
+	/// failed parse stay allocated but belong to no file.
+	class Forest {
+	public:
+		/// Owns an interner with chunked storage, which grows with the files parsed into it.
+		Forest();
+		/// Interns into symbol_interner, which must outlive the forest.
+		explicit Forest(SymbolIntern::symbol_interner_type& symbol_interner);
+
+		Forest(Forest&&);
+		Forest& operator=(Forest&&);
+
+		~Forest();
+
+		/// Number of files.
+		std::size_t size() const;
+		bool empty() const;
+
+		/// Roots of all files in the order they were parsed.
+		std::span<const ast::FileTree* const> file_nodes() const;
+		const ast::FileTree* file_node(std::size_t index) const;
+		std::string_view file_path(std::size_t index) const;
+
+		std::string_view value(const ast::FlatValue* node) const;
+		SymbolIntern::symbol_handle_type find_handle(std::string_view string) const;
+		const SymbolIntern::symbol_interner_type& symbol_interner() const;
+
+		/// Position of node in its own file, empty for nodes of failed parses. node must belong to this forest.
+		const FilePosition get_position(const ast::Node* node) const;
+
+	private:
+		std::unique_ptr<ForestData> _data;
+
+		friend class Parser;
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolMap.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script::ast {
+	/// Assignments directly inside one ListValue or FileTree, grouped by the handle of their key.
+	///
+	/// Built in one pass over the list, duplicate keys keep their source order. Lists are not modified after
+	/// parsing, so an index stays valid for as long as its tree.
+	class KeyIndex {
+	public:
+		KeyIndex() = default;
+
+		/// list must be a ListValue or FileTree, any other node gives an empty index.
+		explicit KeyIndex(const Node* list);
+		/// Indexes the assignments among statements, which may come from several lists.
+		explicit KeyIndex(std::span<const Statement* const> statements);
+
+		/// First assignment to key, nullptr if there is none.
+		const AssignStatement* find(SymbolIntern::symbol_handle_type key) const {
+			auto statements = find_all(key);
+			return statements.empty() ? nullptr : statements.front();
+		}
+
+		/// Every assignment to key in source order.
+		std::span<const AssignStatement* const> find_all(SymbolIntern::symbol_handle_type key) const {
+			auto* range = _ranges.find(key);
+			if (range == nullptr) {
+				return {};
+			}
+			return { _statements.data() + range->begin, range->count };
+		}
+
+		/// Number of distinct keys.
+		std::size_t size() const {
+			return _ranges.size();
+		}
+
+		bool empty() const {
+			return _ranges.empty();
+		}
+
+	private:
+		struct statement_range {
+			std::uint32_t begin = 0;
+			std::uint32_t count = 0;
+		};
+
+		void _group(std::vector<std::pair<SymbolIntern::symbol_handle_type, const AssignStatement*>>& keyed);
+
+		symbol_map<statement_range> _ranges;
+		std::vector<const AssignStatement*> _statements;
+	};
+}
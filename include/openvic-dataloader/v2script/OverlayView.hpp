@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolMap.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/KeyIndex.hpp>
+
+namespace ovdl::v2script::ast {
+	enum class MergeMode : std::uint8_t {
+		/// Assignments of every layer are kept.
+		Append,
+		/// Assignments of the highest layer assigning the key replace those of all lower layers.
+		Replace,
+	};
+
+	/// How an OverlayView merges assignments, per key with a fallback for keys without a rule.
+	struct MergeRules {
+		MergeMode default_mode = MergeMode::Append;
+		symbol_map<MergeMode> key_modes;
+
+		MergeMode mode_of(SymbolIntern::symbol_handle_type key) const {
+			auto* mode = key_modes.find(key);
+			return mode ? *mode : default_mode;
+		}
+	};
+
+	/// The statements of several lists, like a vanilla file and the mods overriding it, as one sequence.
+	///
+	/// Layers are ListValues or FileTrees ordered from lowest to highest priority, their keys must come from one
+	/// shared interner. Only top-level statement pointers are gathered, nodes are neither copied nor modified, so
+	/// building a view is linear in the number of top-level statements and the layers must outlive it.
+	/// Statements keep their layer order, replaced keys therefore appear where the replacing layer has them.
+	/// Statements that are not assignments are always kept.
+	class OverlayView {
+	public:
+		OverlayView() = default;
+		OverlayView(std::span<const Node* const> layers, const MergeRules& rules);
+
+		std::span<const Statement* const> statements() const {
+			return _statements;
+		}
+
+		std::size_t size() const {
+			return _statements.size();
+		}
+
+		bool empty() const {
+			return _statements.empty();
+		}
+
+		/// Index into the layers passed on construction of the layer statements()[index] came from.
+		std::size_t layer_of(std::size_t index) const {
+			return _layers[index];
+		}
+
+		/// First merged assignment to key, nullptr if there is none.
+		const AssignStatement* find(SymbolIntern::symbol_handle_type key) const {
+			return _keys.find(key);
+		}
+
+		/// Every merged assignment to key in view order.
+		std::span<const AssignStatement* const> find_all(SymbolIntern::symbol_handle_type key) const {
+			return _keys.find_all(key);
+		}
+
+	private:
+		std::vector<const Statement*> _statements;
+		std::vector<std::uint32_t> _layers;
+		KeyIndex _keys;
+	};
+}
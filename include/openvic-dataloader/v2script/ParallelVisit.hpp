@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/detail/WorkStealing.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script::ast {
+	struct ParallelVisitOptions {
+		/// 0 uses std::thread::hardware_concurrency.
+		std::size_t thread_count = 0;
+		/// Node count chunks are cut at, smaller chunks balance better but cost more scheduling.
+		std::size_t nodes_per_chunk = 4096;
+	};
+
+	using StatementChunk = std::span<const Statement* const>;
+
+	/// Splits statements into consecutive chunks of at least nodes_per_chunk nodes each, counting every node in
+	/// a statement's subtree, the last chunk may be smaller. Chunks only depend on the tree and nodes_per_chunk.
+	std::vector<StatementChunk> partition_statements(StatementChunk statements, std::size_t nodes_per_chunk);
+
+	/// Runs visitor(StatementChunk) on every chunk of statements on a work-stealing pool and returns the
+	/// visitor results in chunk order, which is source order no matter how chunks were scheduled.
+	///
+	/// visitor runs concurrently on several threads, it may only read the tree and must not use the lazily
+	/// built caches of its parser such as statement_array, find or positions. Non-void results must be default
+	/// constructible. Parser::statement_array(parser.get_file_node()) gives the top-level statements of a file.
+	template<typename Visitor>
+	auto parallel_visit(StatementChunk statements, Visitor&& visitor, const ParallelVisitOptions& options = {}) {
+		using result_type = std::invoke_result_t<Visitor&, StatementChunk>;
+		using results_type = std::conditional_t<std::is_void_v<result_type>, std::vector<char>, std::vector<result_type>>;
+
+		struct context_type {
+			std::vector<StatementChunk> chunks;
+			std::remove_reference_t<Visitor>* visitor;
+			results_type results;
+		} context { partition_statements(statements, options.nodes_per_chunk), &visitor, {} };
+
+		if constexpr (!std::is_void_v<result_type>) {
+			context.results.resize(context.chunks.size());
+		}
+
+		detail::run_work_stealing(context.chunks.size(), options.thread_count, [](void* ptr, std::size_t index) {
+			auto& context = *static_cast<context_type*>(ptr);
+			if constexpr (std::is_void_v<result_type>) {
+				(*context.visitor)(context.chunks[index]);
+			} else {
+				context.results[index] = (*context.visitor)(context.chunks[index]);
+			}
+		}, &context);
+
+		if constexpr (!std::is_void_v<result_type>) {
+			return std::move(context.results);
+		}
+	}
+
+	/// parallel_visit, then merge(accumulator, result) folds the results into the first one in chunk order, so the
+	/// outcome is deterministic even for merges that are not commutative. Empty statements give a default result.
+	template<typename Visitor, typename Merge>
+		requires(!std::is_same_v<std::remove_cvref_t<Merge>, ParallelVisitOptions>)
+	auto parallel_visit(StatementChunk statements, Visitor&& visitor, Merge&& merge, const ParallelVisitOptions& options = {}) {
+		auto results = parallel_visit(statements, visitor, options);
+		using result_type = typename decltype(results)::value_type;
+		if (results.empty()) {
+			return result_type {};
+		}
+
+		auto accumulator = std::move(results.front());
+		for (std::size_t i = 1; i < results.size(); ++i) {
+			merge(accumulator, std::move(results[i]));
+		}
+		return accumulator;
+	}
+}
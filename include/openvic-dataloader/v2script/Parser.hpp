@@ -5,16 +5,24 @@
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <openvic-dataloader/Error.hpp>
 #include <openvic-dataloader/NodeLocation.hpp>
 #include <openvic-dataloader/Parser.hpp>
 #include <openvic-dataloader/detail/Concepts.hpp>
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
 #include <openvic-dataloader/detail/Encoding.hpp>
 #include <openvic-dataloader/detail/ErrorRange.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/DetachedFile.hpp>
+#include <openvic-dataloader/v2script/FlatTree.hpp>
+#include <openvic-dataloader/v2script/Forest.hpp>
+#include <openvic-dataloader/v2script/PathQuery.hpp>
 
 namespace ovdl::v2script {
 	using FileTree = ast::FileTree;
@@ -25,6 +33,28 @@ namespace ovdl::v2script {
 		Parser();
 		Parser(std::basic_ostream<char>& error_stream);
 
+		/// Interns all symbols into symbol_interner instead of a per-file interner.
+		///
+		/// Parsers sharing an interner produce identical symbols and handles for identical strings,
+		/// so keys may be compared across files. The interner must outlive the parser and its nodes,
+		/// must be sized for the whole load session and must not be used from several threads at once.
+		explicit Parser(SymbolIntern::symbol_interner_type& symbol_interner);
+		Parser(SymbolIntern::symbol_interner_type& symbol_interner, std::basic_ostream<char>& error_stream);
+
+		/// Selects how symbols of buffers loaded afterwards are stored, overriding default_symbol_storage().
+		/// Chunked storage reserves no address space up front, which helps when many parsers are alive at once.
+		void set_symbol_storage(symbol_storage storage);
+
+		/// Interns all symbols into a thread-safe interner, parsers on different threads may share it.
+		/// Each parser itself must still only be used from one thread at a time.
+		explicit Parser(ConcurrentSymbolIntern::symbol_interner_type& symbol_interner);
+		Parser(ConcurrentSymbolIntern::symbol_interner_type& symbol_interner, std::basic_ostream<char>& error_stream);
+
+		/// Creates nodes, symbols and locations in forest, which must outlive the parser, and adds every
+		/// successfully parsed file to it. The forest keeps the trees once the parser moves on or is destroyed.
+		explicit Parser(Forest& forest);
+		Parser(Forest& forest, std::basic_ostream<char>& error_stream);
+
 		static Parser from_buffer(const char* data, std::size_t size, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
 		static Parser from_buffer(const char* start, const char* end, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
 		static Parser from_string(const std::string_view string, std::optional<detail::Encoding> encoding_fallback = std::nullopt);
@@ -47,14 +77,45 @@ namespace ovdl::v2script {
 		bool lua_defines_parse();
 
 		const FileTree* get_file_node() const;
+		/// Flattens the parsed file into a preorder array for linear read-only passes.
+		ast::FlatTree make_flat_tree() const;
 
 		std::string_view value(const ovdl::v2script::ast::FlatValue* node) const;
 		ovdl::symbol<char> find_intern(std::string_view string) const;
+		SymbolIntern::symbol_handle_type find_handle(std::string_view string) const;
+
+		/// Statements directly inside list, a ListValue or FileTree, as a contiguous array built on first use.
+		/// Use ListValue::statement_count or FileTree::statement_count when only the count is needed.
+		std::span<const ast::Statement* const> statement_array(const ast::Node* list) const;
+		/// nullptr if index is out of range.
+		const ast::Statement* statement_at(const ast::Node* list, std::size_t index) const;
+
+		/// Compiles path against this parser's interner, see ast::PathQuery. A query compiled by one parser
+		/// runs on every parser sharing its symbol interner.
+		ast::PathQuery compile_query(std::string_view path) const;
+		/// Lazily yields the results of query below root, the parsed file if root is nullptr.
+		/// query must outlive the returned cursor.
+		ast::PathQuery::Cursor query(const ast::PathQuery& query, const ast::Node* root = nullptr) const;
+
+		/// First assignment to key directly inside list, a ListValue or FileTree, nullptr if there is none.
+		/// Each list is indexed by key on its first lookup, repeated lookups do not walk the list again.
+		const ast::AssignStatement* find(const ast::Node* list, SymbolIntern::symbol_handle_type key) const;
+		const ast::AssignStatement* find(const ast::Node* list, std::string_view key) const;
+		/// Every assignment to key directly inside list in source order.
+		std::span<const ast::AssignStatement* const> find_all(const ast::Node* list, SymbolIntern::symbol_handle_type key) const;
+		std::span<const ast::AssignStatement* const> find_all(const ast::Node* list, std::string_view key) const;
+		/// The parser's sequential interner. Must not be called when constructed with a concurrent interner,
+		/// symbol_resolver works for both.
+		const SymbolIntern::symbol_interner_type& symbol_interner() const;
+		/// Resolves handles of this parser's nodes in whichever interner they were interned into.
+		SymbolResolver symbol_resolver() const;
 
 		std::string make_native_string() const;
 		std::string make_list_string() const;
 
 		const FilePosition get_position(const ast::Node* node) const;
+		/// Positions of many nodes at once, resolving them in offset order instead of one by one.
+		std::vector<FilePosition> get_positions(std::span<const ast::Node* const> nodes) const;
 
 		using error_range = ovdl::detail::error_range<error::Root>;
 		Parser::error_range get_errors() const;
@@ -65,6 +126,12 @@ namespace ovdl::v2script {
 
 		void print_errors_to(std::basic_ostream<char>& stream) const;
 
+		/// Moves the parsed file out into a DetachedFile and releases the source buffer and all parse state,
+		/// errors included. The parser is left without a loaded buffer, as if newly constructed.
+		/// Nodes, symbols and handles obtained before stay valid and belong to the returned file.
+		/// Returns an empty file for parsers of a Forest, which already keeps their trees.
+		DetachedFile detach();
+
 		Parser(Parser&&);
 		Parser& operator=(Parser&&);
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+namespace ovdl::v2script::ast {
+	/// Path through nested assignments, compiled once into symbol handles.
+	///
+	/// A path like "political_decisions/*/potential/has_country_flag" is a '/' separated list of keys, "*" matches
+	/// any key. Every step but the last descends into the ListValue assigned to a matching key, the assignments
+	/// matching the last step are the results.
+	class PathQuery {
+	public:
+		struct Step {
+			SymbolIntern::symbol_handle_type key;
+			bool is_wildcard = false;
+		};
+
+		/// Maps a ListValue or FileTree to its statements, context is passed through unchanged.
+		using statements_fn = std::span<const Statement* const> (*)(const void* context, const Node* list);
+
+		/// Yields the results of a query below a root lazily, depth first in source order.
+		///
+		/// The traversal stack is allocated once per cursor and reused by reset, stepping does not allocate.
+		class Cursor {
+		public:
+			Cursor(const PathQuery& query, statements_fn statements, const void* context);
+
+			/// Restarts below root, a ListValue or FileTree.
+			void reset(const Node* root);
+
+			/// The next result, nullptr once exhausted.
+			const AssignStatement* next();
+
+		private:
+			struct Frame {
+				std::span<const Statement* const> statements;
+				std::size_t index = 0;
+			};
+
+			const PathQuery* _query;
+			statements_fn _statements;
+			const void* _context;
+			std::vector<Frame> _frames;
+		};
+
+		PathQuery() = default;
+
+		/// find_handle maps a key to its handle in the interner of the trees the query runs on. A key that was
+		/// never interned there cannot match, neither can a path with an empty step.
+		template<typename FindHandle>
+		static PathQuery compile(std::string_view path, FindHandle&& find_handle) {
+			PathQuery result;
+			result._can_match = !path.empty();
+			while (result._can_match) {
+				auto separator = path.find('/');
+				auto key = path.substr(0, separator);
+
+				Step step;
+				if (key == "*") {
+					step.is_wildcard = true;
+				} else {
+					step.key = find_handle(key);
+					result._can_match = !key.empty() && bool(step.key);
+				}
+				result._steps.push_back(step);
+
+				if (separator == std::string_view::npos) {
+					break;
+				}
+				path.remove_prefix(separator + 1);
+			}
+			return result;
+		}
+
+		std::span<const Step> steps() const {
+			return _steps;
+		}
+
+		/// False if some step can never match, running the query then yields nothing.
+		bool can_match() const {
+			return _can_match;
+		}
+
+		/// Whether statement's key matches the step at depth.
+		bool matches(std::size_t depth, const AssignStatement* statement) const;
+
+	private:
+		std::vector<Step> _steps;
+		bool _can_match = false;
+	};
+}
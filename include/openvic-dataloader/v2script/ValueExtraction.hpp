@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+#include <dryad/node.hpp>
+
+namespace ovdl::v2script::ast {
+	/// Outcome of converting the members of a ListValue into an array.
+	struct ExtractResult {
+		enum class Error : std::uint8_t {
+			None,
+			/// A member is not a value statement holding a number of the requested kind.
+			NotNumeric,
+			/// A member is numeric but does not fit the requested type.
+			OutOfRange,
+			/// The list has more members than the output array.
+			TooManyValues,
+		};
+
+		/// Number of values written, the members before failed_statement on error.
+		std::size_t count = 0;
+		Error error = Error::None;
+		/// The member that failed, nullptr on success and for TooManyValues.
+		const Statement* failed_statement = nullptr;
+
+		explicit operator bool() const {
+			return error == Error::None;
+		}
+	};
+
+	/// Calls convert(const FlatValue*, T&) for the value of every member of list in order, stopping at the first
+	/// failure. convert returns ExtractResult::Error::None on success, members that are not value statements
+	/// holding a flat value fail with NotNumeric.
+	template<typename T, typename Convert>
+	ExtractResult extract_list(const ListValue* list, std::span<T> out, Convert&& convert) {
+		ExtractResult result;
+		if (list == nullptr) {
+			return result;
+		}
+
+		for (const auto* statement : list->statements()) {
+			if (result.count == out.size()) {
+				result.error = ExtractResult::Error::TooManyValues;
+				return result;
+			}
+
+			auto* value_statement = dryad::node_try_cast<ValueStatement>(statement);
+			auto* value = value_statement ? dryad::node_try_cast<FlatValue>(value_statement->value()) : nullptr;
+			auto error = value ? convert(value, out[result.count]) : ExtractResult::Error::NotNumeric;
+			if (error != ExtractResult::Error::None) {
+				result.error = error;
+				result.failed_statement = statement;
+				return result;
+			}
+			++result.count;
+		}
+		return result;
+	}
+
+	/// Converts a list of numbers like { 0.25 1 -3.5 } into fixed-point values with fractional_bits fractional
+	/// bits, see FlatValue::as_fixed_point.
+	template<typename SymbolResolver>
+	ExtractResult extract_fixed_point(const ListValue* list, const SymbolResolver& symbols, unsigned fractional_bits, std::span<std::int64_t> out) {
+		return extract_list(list, out, [&](const FlatValue* value, std::int64_t& result) {
+			if (!value->is_number()) {
+				return ExtractResult::Error::NotNumeric;
+			}
+			auto fixed = value->as_fixed_point(symbols, fractional_bits);
+			if (!fixed) {
+				return ExtractResult::Error::OutOfRange;
+			}
+			result = *fixed;
+			return ExtractResult::Error::None;
+		});
+	}
+
+	/// Converts a list of numbers like { 120 45 200 } into out in one pass.
+	///
+	/// Integral T takes integer members only, decimals fail with NotNumeric and values outside T with OutOfRange.
+	/// Floating-point T takes integers and decimals, rounded to the nearest T, finite values beyond its range
+	/// fail with OutOfRange. Every member is decoded at most once, see FlatValue::as_integer.
+	template<typename T, typename SymbolResolver>
+		requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+	ExtractResult extract_numbers(const ListValue* list, const SymbolResolver& symbols, std::span<T> out) {
+		return extract_list(list, out, [&](const FlatValue* value, T& result) {
+			if constexpr (std::is_integral_v<T>) {
+				if (value->value_class() != FlatValueClass::Integer) {
+					return ExtractResult::Error::NotNumeric;
+				}
+				auto integer = value->as_integer(symbols);
+				if (!integer || !std::in_range<T>(*integer)) {
+					return ExtractResult::Error::OutOfRange;
+				}
+				result = T(*integer);
+			} else {
+				if (!value->is_number()) {
+					return ExtractResult::Error::NotNumeric;
+				}
+				auto decimal = value->as_decimal(symbols);
+				if (!decimal || *decimal > double(std::numeric_limits<T>::max()) || *decimal < double(std::numeric_limits<T>::lowest())) {
+					return ExtractResult::Error::OutOfRange;
+				}
+				result = T(*decimal);
+			}
+			return ExtractResult::Error::None;
+		});
+	}
+}
@@ -1,15 +1,40 @@
 #include "AbstractSyntaxTree.hpp"
 
+#include <cassert>
+
 using namespace ovdl;
 
 AbstractSyntaxTree::symbol_type AbstractSyntaxTree::intern(const char* str, std::size_t length) {
-	return _symbol_interner.intern(str, length);
+	return resolve(intern_handle(str, length));
 }
 
 AbstractSyntaxTree::symbol_type AbstractSyntaxTree::intern(std::string_view str) {
 	return intern(str.data(), str.size());
 }
 
+AbstractSyntaxTree::symbol_handle_type AbstractSyntaxTree::intern_handle(const char* str, std::size_t length) {
+	if (_concurrent_symbol_interner) {
+		return _concurrent_symbol_interner->intern_handle(str, length);
+	}
+	return symbol_interner().intern_handle(str, length);
+}
+
+AbstractSyntaxTree::symbol_handle_type AbstractSyntaxTree::intern_handle(std::string_view str) {
+	return intern_handle(str.data(), str.size());
+}
+
+bool AbstractSyntaxTree::intern_many(std::span<const std::string_view> strings, std::span<symbol_handle_type> handles) {
+	if (_concurrent_symbol_interner) {
+		bool result = true;
+		for (std::size_t i = 0; i < strings.size(); ++i) {
+			handles[i] = _concurrent_symbol_interner->intern_handle(strings[i].data(), strings[i].size());
+			result &= bool(handles[i]);
+		}
+		return result;
+	}
+	return symbol_interner().intern_many(strings, handles);
+}
+
 const char* AbstractSyntaxTree::intern_cstr(const char* str, std::size_t length) {
 	return intern(str, length).c_str();
 }
@@ -19,9 +44,59 @@ const char* AbstractSyntaxTree::intern_cstr(std::string_view str) {
 }
 
 AbstractSyntaxTree::symbol_interner_type& AbstractSyntaxTree::symbol_interner() {
-	return _symbol_interner;
+	assert(_concurrent_symbol_interner == nullptr && "symbols are in the concurrent interner, use symbol_resolver");
+	return _shared_symbol_interner ? *_shared_symbol_interner : _symbol_interner;
 }
 
 const AbstractSyntaxTree::symbol_interner_type& AbstractSyntaxTree::symbol_interner() const {
-	return _symbol_interner;
+	assert(_concurrent_symbol_interner == nullptr && "symbols are in the concurrent interner, use symbol_resolver");
+	return _shared_symbol_interner ? *_shared_symbol_interner : _symbol_interner;
+}
+
+SymbolResolver AbstractSyntaxTree::symbol_resolver() const {
+	if (_concurrent_symbol_interner) {
+		return { nullptr, _concurrent_symbol_interner };
+	}
+	return { &symbol_interner(), nullptr };
+}
+
+AbstractSyntaxTree::symbol_type AbstractSyntaxTree::resolve(symbol_handle_type handle) const {
+	if (_concurrent_symbol_interner) {
+		return _concurrent_symbol_interner->resolve(handle);
+	}
+	return symbol_interner().resolve(handle);
+}
+
+AbstractSyntaxTree::symbol_type AbstractSyntaxTree::find_intern(const char* str, std::size_t length) const {
+	return resolve(find_handle(str, length));
+}
+
+AbstractSyntaxTree::symbol_handle_type AbstractSyntaxTree::find_handle(const char* str, std::size_t length) const {
+	if (_concurrent_symbol_interner) {
+		return _concurrent_symbol_interner->find_handle(str, length);
+	}
+	return symbol_interner().find_handle(str, length);
+}
+
+void AbstractSyntaxTree::set_symbol_interner(symbol_interner_type* interner) {
+	assert((has_shared_symbol_interner() || _symbol_interner.size() == 0) && "symbol interner must be set before interning");
+	if (interner != nullptr) {
+		// Drop the reservation made for this tree's own symbols, they will never be used.
+		_symbol_interner = _make_unused_symbol_interner();
+	}
+	_shared_symbol_interner = interner;
+	_concurrent_symbol_interner = nullptr;
+}
+
+void AbstractSyntaxTree::set_symbol_interner(concurrent_symbol_interner_type* interner) {
+	assert((has_shared_symbol_interner() || _symbol_interner.size() == 0) && "symbol interner must be set before interning");
+	if (interner != nullptr) {
+		_symbol_interner = _make_unused_symbol_interner();
+	}
+	_shared_symbol_interner = nullptr;
+	_concurrent_symbol_interner = interner;
+}
+
+bool AbstractSyntaxTree::has_shared_symbol_interner() const {
+	return _shared_symbol_interner != nullptr || _concurrent_symbol_interner != nullptr;
 }
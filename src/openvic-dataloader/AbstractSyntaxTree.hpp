@@ -2,11 +2,13 @@
 
 #include <concepts>
 #include <cstdio>
+#include <span>
 #include <string_view>
 #include <type_traits>
 #include <utility>
 
 #include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
 #include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/detail/Utility.hpp>
 
@@ -20,10 +22,38 @@
 
 namespace ovdl {
 	struct AbstractSyntaxTree : SymbolIntern {
+		using concurrent_symbol_interner_type = ConcurrentSymbolIntern::symbol_interner_type;
+
+		/// While alive, trees constructed on this thread are about to get a shared interner and skip sizing their own.
+		struct shared_symbol_interner_scope {
+			explicit shared_symbol_interner_scope(bool is_shared) : _previous(_is_active) {
+				_is_active = _is_active || is_shared;
+			}
+
+			~shared_symbol_interner_scope() {
+				_is_active = _previous;
+			}
+
+			shared_symbol_interner_scope(const shared_symbol_interner_scope&) = delete;
+			shared_symbol_interner_scope& operator=(const shared_symbol_interner_scope&) = delete;
+
+			static bool is_active() {
+				return _is_active;
+			}
+
+		private:
+			bool _previous;
+			inline static thread_local bool _is_active = false;
+		};
+
 		AbstractSyntaxTree() = default;
-		explicit AbstractSyntaxTree(std::size_t max_elements) : _symbol_interner(max_elements) {}
+		explicit AbstractSyntaxTree(std::size_t max_elements)
+			: _symbol_interner(shared_symbol_interner_scope::is_active() ? _make_unused_symbol_interner() : symbol_interner_type(max_elements)) {}
 
-		AbstractSyntaxTree(AbstractSyntaxTree&& other) : _symbol_interner { std::move(other._symbol_interner) } {}
+		AbstractSyntaxTree(AbstractSyntaxTree&& other)
+			: _symbol_interner { std::move(other._symbol_interner) },
+			  _shared_symbol_interner { other._shared_symbol_interner },
+			  _concurrent_symbol_interner { other._concurrent_symbol_interner } {}
 		AbstractSyntaxTree& operator=(AbstractSyntaxTree&& rhs) {
 			this->~AbstractSyntaxTree();
 			new (this) AbstractSyntaxTree(std::move(rhs));
@@ -33,22 +63,51 @@ namespace ovdl {
 
 		symbol_type intern(const char* str, std::size_t length);
 		symbol_type intern(std::string_view str);
+		symbol_handle_type intern_handle(const char* str, std::size_t length);
+		symbol_handle_type intern_handle(std::string_view str);
+		/// Interns a batch of strings collected before node creation, see symbol_interner::intern_many.
+		bool intern_many(std::span<const std::string_view> strings, std::span<symbol_handle_type> handles);
 		const char* intern_cstr(const char* str, std::size_t length);
 		const char* intern_cstr(std::string_view str);
+		/// The sequential interner, must not be called when interning into a concurrent interner.
 		symbol_interner_type& symbol_interner();
 		const symbol_interner_type& symbol_interner() const;
+		/// Resolves in whichever interner this tree interns into.
+		SymbolResolver symbol_resolver() const;
+
+		/// Resolves and looks up symbols in whichever interner this tree interns into.
+		symbol_type resolve(symbol_handle_type handle) const;
+		symbol_type find_intern(const char* str, std::size_t length) const;
+		symbol_handle_type find_handle(const char* str, std::size_t length) const;
+
+		/// Interns into an externally owned interner instead of this tree's own, the interner must outlive the tree.
+		/// Must be set before anything was interned, nullptr restores the tree's own interner.
+		void set_symbol_interner(symbol_interner_type* interner);
+		void set_symbol_interner(concurrent_symbol_interner_type* interner);
+		bool has_shared_symbol_interner() const;
 
 		template<typename Reader>
 		symbol_type intern(lexy::lexeme<Reader> lexeme) {
 			return intern(lexeme.begin(), lexeme.size());
 		}
 		template<typename Reader>
+		symbol_handle_type intern_handle(lexy::lexeme<Reader> lexeme) {
+			return intern_handle(lexeme.begin(), lexeme.size());
+		}
+		template<typename Reader>
 		const char* intern_cstr(lexy::lexeme<Reader> lexeme) {
 			return intern_cstr(lexeme.begin(), lexeme.size());
 		}
 
 	protected:
+		// Chunked storage reserves nothing up front.
+		static symbol_interner_type _make_unused_symbol_interner() {
+			return symbol_interner_type(0, symbol_storage::chunked);
+		}
+
 		symbol_interner_type _symbol_interner;
+		symbol_interner_type* _shared_symbol_interner = nullptr;
+		concurrent_symbol_interner_type* _concurrent_symbol_interner = nullptr;
 	};
 
 	template<detail::IsFile FileT, std::derived_from<typename FileT::node_type> RootNodeT>
@@ -74,6 +133,8 @@ namespace ovdl {
 		BasicAbstractSyntaxTree(BasicAbstractSyntaxTree&& other)
 			: _tree { std::move(other._tree) },
 			  _file { std::move(other._file) },
+			  _node_arena { other._node_arena },
+			  _arena_root { other._arena_root },
 			  AbstractSyntaxTree(std::move(other)) {}
 
 		BasicAbstractSyntaxTree& operator=(AbstractSyntaxTree&& rhs) {
@@ -92,11 +153,19 @@ namespace ovdl {
 		}
 
 		root_node_type* root() {
-			return _tree.root();
+			return _node_arena ? _arena_root : _tree.root();
 		}
 
 		const root_node_type* root() const {
-			return _tree.root();
+			return _node_arena ? _arena_root : _tree.root();
+		}
+
+		/// Creates nodes in the tree arena instead of this tree's own, so many files can share one allocation.
+		/// The arena's root is never set, set_root only records the root here. Must be set before any node was
+		/// created, the arena must outlive all nodes.
+		void set_node_arena(dryad::tree<root_node_type>* arena) {
+			_node_arena = arena;
+			_arena_root = nullptr;
 		}
 
 		file_type& file() {
@@ -109,7 +178,8 @@ namespace ovdl {
 
 		template<typename T, typename... Args>
 		T* create(NodeLocation loc, Args&&... args) {
-			auto node = _tree.template create<T>(static_cast<decltype(args)>(args)...);
+			auto& arena = _node_arena ? *_node_arena : _tree;
+			auto node = arena.template create<T>(static_cast<decltype(args)>(args)...);
 			set_location(node, loc);
 			return node;
 		}
@@ -120,11 +190,17 @@ namespace ovdl {
 		}
 
 		void set_root(root_node_type* node) {
+			if (_node_arena) {
+				_arena_root = node;
+				return;
+			}
 			_tree.set_root(node);
 		}
 
 	protected:
 		dryad::tree<root_node_type> _tree;
 		file_type _file;
+		dryad::tree<root_node_type>* _node_arena = nullptr;
+		root_node_type* _arena_root = nullptr;
 	};
 }
@@ -10,6 +10,6 @@ bool DiagnosticLogger::errored() const { return _errored; }
 bool DiagnosticLogger::warned() const { return _warned; }
 
 NodeLocation DiagnosticLogger::location_of(const error::Error* error) const {
-	auto result = _map.lookup(error);
-	return result ? *result : NodeLocation {};
+	auto result = _locations.find(*error);
+	return result ? result->to_location(_buffer_begin) : NodeLocation {};
 }
@@ -23,7 +23,6 @@
 #include <lexy/lexeme.hpp>
 #include <lexy/visualize.hpp>
 
-#include <dryad/node_map.hpp>
 #include <dryad/tree.hpp>
 
 #include <fmt/format.h>
@@ -69,9 +68,6 @@ namespace ovdl {
 						}
 					}
 
-					auto context_location = lexy::get_input_location(context.input(), context.position());
-					auto location = lexy::get_input_location(context.input(), error.position(), context_location.anchor());
-
 					if constexpr (detail::is_instance_of_v<Logger, BasicDiagnosticLogger>) {
 						lexy_ext::diagnostic_writer impl { context.input() };
 
@@ -88,7 +84,9 @@ namespace ovdl {
 						}();
 
 						auto writer = _logger.template parse_error<Tag>(impl, loc, production_name.c_str());
-						if (location.line_nr() != context_location.line_nr()) {
+						// Parsing runs on the file's own buffer, its line index avoids rescanning from the start per error.
+						const auto& file = _logger.file();
+						if (file.line_of(error.position()) != file.line_of(context.position())) {
 							writer.secondary(BasicNodeLocation { context.position(), lexy::_detail::next(context.position()) }, "beginning here").finish();
 						}
 
@@ -153,7 +151,7 @@ namespace ovdl {
 		T* create(BasicNodeLocation<LocCharT> loc, Args&&... args) {
 			using node_creator = dryad::node_creator<decltype(std::declval<T>().kind()), void>;
 			T* result = _tree.create<T>(static_cast<decltype(args)>(args)...);
-			_map.insert(result, loc);
+			_locations.set(*result, CompactNodeLocation::from(loc, _buffer_begin));
 			return result;
 		}
 
@@ -171,7 +169,9 @@ namespace ovdl {
 	protected:
 		bool _errored = false;
 		bool _warned = false;
-		dryad::node_map<const error::Error, NodeLocation> _map;
+		NodeLocationTable _locations;
+		/// Start of the file buffer error locations are relative to.
+		const char* _buffer_begin = nullptr;
 		dryad::tree<error::Root> _tree;
 
 		symbol_interner_type _symbol_interner;
@@ -220,6 +220,7 @@ namespace ovdl {
 
 		explicit BasicDiagnosticLogger(const file_type& file)
 			: _file(&file) {
+			_buffer_begin = file.buffer().data();
 			_tree.set_root(_tree.create<error::Root>());
 		}
 
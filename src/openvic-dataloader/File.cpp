@@ -1,6 +1,11 @@
 #include "File.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <cstring>
+#include <utility>
+#include <vector>
 
 #include <openvic-dataloader/detail/Utility.hpp>
 
@@ -21,3 +26,107 @@ bool File::is_valid() const noexcept {
 std::size_t File::size() const noexcept {
 	return _buffer.size();
 }
+
+void File::build_line_index() const {
+	if (_line_index.empty()) {
+		_line_index = detail::LineIndex(_buffer.data(), _buffer.size());
+	}
+}
+
+std::uint32_t File::line_of(const char* position) const {
+	assert(position >= _buffer.data() && position <= _buffer.data() + _buffer.size());
+	build_line_index();
+	return _line_index.line_of(std::uint32_t(position - _buffer.data()));
+}
+
+FilePosition File::position_of(NodeLocation loc) const {
+	if (loc.is_synthesized()) {
+		return {};
+	}
+
+	build_line_index();
+	auto begin = _line_index.resolve(_buffer.data(), std::uint32_t(loc.begin() - _buffer.data()));
+	FilePosition result { begin.line, begin.line, begin.column, begin.column };
+	if (loc.begin() < loc.end()) {
+		auto end = _line_index.resolve(_buffer.data(), std::uint32_t(loc.end() - _buffer.data()));
+		result.end_line = end.line;
+		result.end_column = end.column;
+	}
+	return result;
+}
+
+FilePosition File::position_of(CompactNodeLocation loc) const {
+	if (loc.is_synthesized()) {
+		return {};
+	}
+
+	if (!_line_index.is_detached()) {
+		return position_of(loc.to_location(_buffer.data()));
+	}
+
+	auto begin = _line_index.resolve(loc.begin_offset());
+	FilePosition result { begin.line, begin.line, begin.column, begin.column };
+	if (loc.begin_offset() < loc.end_offset()) {
+		auto end = _line_index.resolve(loc.end_offset());
+		result.end_line = end.line;
+		result.end_column = end.column;
+	}
+	return result;
+}
+
+detail::LineIndex File::make_detached_line_index() const {
+	if (_line_index.is_detached()) {
+		return _line_index;
+	}
+
+	build_line_index();
+	auto result = _line_index;
+	result.detach(_buffer.data(), _buffer.size());
+	return result;
+}
+
+void File::release_buffer() {
+	if (_line_index.is_detached()) {
+		return;
+	}
+
+	build_line_index();
+	_line_index.detach(_buffer.data(), _buffer.size());
+	_buffer = decltype(_buffer)();
+}
+
+void File::positions_of(std::span<const NodeLocation> locations, std::span<FilePosition> out) const {
+	assert(out.size() >= locations.size());
+	build_line_index();
+
+	// Both ends of every location, each paired with where its result goes.
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> ends;
+	ends.reserve(locations.size() * 2);
+	for (std::size_t i = 0; i < locations.size(); ++i) {
+		out[i] = {};
+		if (locations[i].is_synthesized()) {
+			continue;
+		}
+		ends.emplace_back(std::uint32_t(locations[i].begin() - _buffer.data()), std::uint32_t(i * 2));
+		if (locations[i].begin() < locations[i].end()) {
+			ends.emplace_back(std::uint32_t(locations[i].end() - _buffer.data()), std::uint32_t(i * 2 + 1));
+		}
+	}
+	std::sort(ends.begin(), ends.end());
+
+	std::vector<std::uint32_t> offsets(ends.size());
+	std::transform(ends.begin(), ends.end(), offsets.begin(), [](const auto& end) { return end.first; });
+	std::vector<detail::LineIndex::LineColumn> resolved(ends.size());
+	_line_index.resolve_sorted(_buffer.data(), offsets, resolved);
+
+	for (std::size_t i = 0; i < ends.size(); ++i) {
+		auto& position = out[ends[i].second / 2];
+		if (ends[i].second % 2 == 0) {
+			// An end offset sorts after its begin, so this only stays for zero-width locations.
+			position = { resolved[i].line, resolved[i].line, resolved[i].column, resolved[i].column };
+		} else {
+			position.end_line = resolved[i].line;
+			position.end_column = resolved[i].column;
+		}
+	}
+}
@@ -2,6 +2,8 @@
 
 #include <cassert>
 #include <concepts> // IWYU pragma: keep
+#include <cstdint>
+#include <span>
 #include <type_traits>
 
 #include <openvic-dataloader/NodeLocation.hpp>
@@ -13,6 +15,8 @@
 
 #include <dryad/node_map.hpp>
 
+#include "detail/LineIndex.hpp"
+
 namespace ovdl {
 	struct File {
 		using buffer_ids = detail::TypeRegister<
@@ -41,9 +45,33 @@ namespace ovdl {
 			return _buffer;
 		}
 
+		/// Line and column span of loc, empty for synthesized locations.
+		///
+		/// The line index is built on first use, call build_line_index beforehand when resolving from several threads.
+		FilePosition position_of(NodeLocation loc) const;
+
+		/// Resolves every location of locations into out, sorting their offsets so each line is scanned once.
+		void positions_of(std::span<const NodeLocation> locations, std::span<FilePosition> out) const;
+
+		/// Like position_of(NodeLocation), and still resolves after release_buffer.
+		FilePosition position_of(CompactNodeLocation loc) const;
+
+		/// 1-based line containing position, which must point into the buffer.
+		std::uint32_t line_of(const char* position) const;
+
+		void build_line_index() const;
+
+		/// Copy of the line index that resolves offsets without the buffer, see LineIndex::detach.
+		detail::LineIndex make_detached_line_index() const;
+
+		/// Frees the buffer, keeping just enough of it in the line index for position_of(CompactNodeLocation).
+		/// Everything else reading the buffer, including is_valid, treats the file as empty afterwards.
+		void release_buffer();
+
 	protected:
 		const char* _path = "";
 		lexy::buffer<lexy::utf8_char_encoding, void> _buffer;
+		mutable detail::LineIndex _line_index;
 	};
 
 	template<typename NodeT>
@@ -62,17 +90,53 @@ namespace ovdl {
 			_buffer = static_cast<std::remove_reference_t<decltype(buffer)>&&>(buffer);
 		}
 
+		/// Stores slot locations in table instead of this file's own, for sharing one table between many files.
+		/// Must be set before any location, table must outlive this file.
+		void set_location_table(NodeLocationTable* table) {
+			_shared_locations = table;
+		}
+
 		void set_location(const node_type* n, NodeLocation loc) {
-			_map.insert(n, loc);
+			auto compact = CompactNodeLocation::from(loc, _buffer.data());
+			if constexpr (detail::HasLocationSlot<node_type>) {
+				if (auto* slot = location_slot(n)) {
+					_location_table().set(*slot, compact);
+					return;
+				}
+			}
+			_map.insert(n, compact);
 		}
 
 		NodeLocation location_of(const node_type* n) const {
-			auto result = _map.lookup(n);
+			return compact_location_of(n).to_location(_buffer.data());
+		}
+
+		/// Unlike location_of, remains usable after release_buffer.
+		CompactNodeLocation compact_location_of(const node_type* n) const {
+			const CompactNodeLocation* result = nullptr;
+			if constexpr (detail::HasLocationSlot<node_type>) {
+				if (auto* slot = location_slot(n)) {
+					result = _location_table().find(*slot);
+				}
+			}
+			if (result == nullptr) {
+				result = _map.lookup(n);
+			}
 			DRYAD_ASSERT(result != nullptr, "every Node should have a NodeLocation");
 			return *result;
 		}
 
 	protected:
-		dryad::node_map<const node_type, NodeLocation> _map;
+		NodeLocationTable& _location_table() {
+			return _shared_locations ? *_shared_locations : _locations;
+		}
+		const NodeLocationTable& _location_table() const {
+			return _shared_locations ? *_shared_locations : _locations;
+		}
+
+		NodeLocationTable _locations;
+		NodeLocationTable* _shared_locations = nullptr;
+		/// Fallback for nodes without a LocationSlot.
+		dryad::node_map<const node_type, CompactNodeLocation> _map;
 	};
 }
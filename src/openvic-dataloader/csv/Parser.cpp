@@ -80,6 +80,10 @@ Parser::Parser(std::basic_ostream<char>& error_stream)
 	set_error_log_to(error_stream);
 }
 
+void Parser::set_symbol_storage(symbol_storage storage) {
+	_parse_handler->set_symbol_storage(storage);
+}
+
 Parser::Parser(Parser&&) = default;
 Parser& Parser::operator=(Parser&&) = default;
 Parser::~Parser() = default;
@@ -205,20 +209,9 @@ const FilePosition Parser::get_error_position(const error::Error* error) const {
 	if (!error || !error->is_linked_in_tree()) {
 		return {};
 	}
-	auto err_location = _parse_handler->parse_state().logger().location_of(error);
-	if (err_location.is_synthesized()) {
-		return {};
-	}
 
-	lexy::buffer<lexy::utf8_char_encoding, void> const& buffer = _parse_handler->buffer();
-	auto loc_begin = lexy::get_input_location(buffer, err_location.begin());
-	FilePosition result { loc_begin.line_nr(), loc_begin.line_nr(), loc_begin.column_nr(), loc_begin.column_nr() };
-	if (err_location.begin() < err_location.end()) {
-		auto loc_end = lexy::get_input_location(buffer, err_location.end(), loc_begin.anchor());
-		result.end_line = loc_end.line_nr();
-		result.end_column = loc_end.column_nr();
-	}
-	return result;
+	const auto& parse_state = _parse_handler->parse_state();
+	return parse_state.file().position_of(parse_state.logger().location_of(error));
 }
 
 void Parser::print_errors_to(std::basic_ostream<char>& stream) const {
@@ -0,0 +1,103 @@
+#include "detail/LineIndex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+using namespace ovdl::detail;
+
+LineIndex::LineIndex(const char* begin, std::size_t size) {
+	_line_starts.reserve(size / 32 + 1);
+	_line_starts.push_back(0);
+
+	// memchr is vectorized by every common libc, far faster than a byte loop on long lines.
+	const char* end = begin + size;
+	for (const char* it = begin; it != end;) {
+		auto* newline = static_cast<const char*>(std::memchr(it, '\n', std::size_t(end - it)));
+		if (newline == nullptr) {
+			break;
+		}
+		it = newline + 1;
+		_line_starts.push_back(std::uint32_t(it - begin));
+	}
+}
+
+std::uint32_t LineIndex::_line_of(std::uint32_t offset) const {
+	auto it = std::upper_bound(_line_starts.begin(), _line_starts.end(), offset);
+	return std::uint32_t(it - _line_starts.begin()) - 1;
+}
+
+std::uint32_t LineIndex::_column_of(const char* begin, std::uint32_t line, std::uint32_t offset) const {
+	std::uint32_t column = 1;
+	for (auto i = _line_starts[line]; i < offset; ++i) {
+		// Every byte except UTF-8 continuation bytes starts a code point.
+		column += (static_cast<unsigned char>(begin[i]) & 0xC0) != 0x80;
+	}
+	return column;
+}
+
+LineIndex::LineColumn LineIndex::resolve(const char* begin, std::uint32_t offset) const {
+	assert(!empty());
+	auto line = _line_of(offset);
+	return { line + 1, _column_of(begin, line, offset) };
+}
+
+void LineIndex::resolve_sorted(const char* begin, std::span<const std::uint32_t> offsets, std::span<LineColumn> out) const {
+	assert(!empty() && out.size() >= offsets.size());
+
+	std::uint32_t line = 0;
+	std::uint32_t column_offset = 0;
+	std::uint32_t column = 1;
+	for (std::size_t i = 0; i < offsets.size(); ++i) {
+		auto offset = offsets[i];
+		assert(i == 0 || offsets[i - 1] <= offset);
+
+		if (line + 1 < _line_starts.size() && _line_starts[line + 1] <= offset) {
+			auto next = std::upper_bound(_line_starts.begin() + line + 1, _line_starts.end(), offset);
+			line = std::uint32_t(next - _line_starts.begin()) - 1;
+			column_offset = _line_starts[line];
+			column = 1;
+		}
+
+		// Continue counting from the previous offset on the same line.
+		for (; column_offset < offset; ++column_offset) {
+			column += (static_cast<unsigned char>(begin[column_offset]) & 0xC0) != 0x80;
+		}
+		out[i] = { line + 1, column };
+	}
+}
+
+void LineIndex::detach(const char* begin, std::size_t size) {
+	assert(!empty());
+	_continuation_offsets.clear();
+
+	std::size_t i = 0;
+	for (; i < size; ++i) {
+		// Skips eight ASCII bytes at a time.
+		if (i + 8 <= size) {
+			std::uint64_t word;
+			std::memcpy(&word, begin + i, sizeof(word));
+			if ((word & 0x8080808080808080ull) == 0) {
+				i += 7;
+				continue;
+			}
+		}
+		if ((static_cast<unsigned char>(begin[i]) & 0xC0) == 0x80) {
+			_continuation_offsets.push_back(std::uint32_t(i));
+		}
+	}
+	_continuation_offsets.shrink_to_fit();
+	_line_starts.shrink_to_fit();
+	_is_detached = true;
+}
+
+LineIndex::LineColumn LineIndex::resolve(std::uint32_t offset) const {
+	assert(_is_detached);
+	auto line = _line_of(offset);
+	auto line_start = _line_starts[line];
+
+	auto first = std::lower_bound(_continuation_offsets.begin(), _continuation_offsets.end(), line_start);
+	auto last = std::lower_bound(first, _continuation_offsets.end(), offset);
+	return { line + 1, offset - line_start + 1 - std::uint32_t(last - first) };
+}
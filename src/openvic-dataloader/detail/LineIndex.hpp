@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ovdl::detail {
+	/// Offsets of every line start in a buffer, for resolving offsets to lines and columns without rescanning.
+	///
+	/// Lines end after each '\n', so "\r\n" endings are covered as well. Lines and columns are 1-based and
+	/// columns count UTF-8 code points, matching lexy::get_input_location on valid input.
+	class LineIndex {
+	public:
+		struct LineColumn {
+			std::uint32_t line;
+			std::uint32_t column;
+		};
+
+		LineIndex() = default;
+		LineIndex(const char* begin, std::size_t size);
+
+		bool empty() const {
+			return _line_starts.empty();
+		}
+
+		std::size_t line_count() const {
+			return _line_starts.size();
+		}
+
+		/// 1-based line containing offset.
+		std::uint32_t line_of(std::uint32_t offset) const {
+			return _line_of(offset) + 1;
+		}
+
+		/// begin must be the buffer this index was built from, offset at most its size.
+		LineColumn resolve(const char* begin, std::uint32_t offset) const;
+
+		/// Resolves offsets sorted in ascending order, walking the lines forward instead of searching for each.
+		void resolve_sorted(const char* begin, std::span<const std::uint32_t> offsets, std::span<LineColumn> out) const;
+
+		/// Records where the buffer has UTF-8 continuation bytes, so offsets resolve without it afterwards.
+		/// Mostly ASCII buffers add next to nothing to the line starts.
+		void detach(const char* begin, std::size_t size);
+
+		bool is_detached() const {
+			return _is_detached;
+		}
+
+		/// Like resolve, but without the buffer, requires detach.
+		LineColumn resolve(std::uint32_t offset) const;
+
+	private:
+		std::uint32_t _line_of(std::uint32_t offset) const;
+		std::uint32_t _column_of(const char* begin, std::uint32_t line, std::uint32_t offset) const;
+
+		std::vector<std::uint32_t> _line_starts;
+		std::vector<std::uint32_t> _continuation_offsets;
+		bool _is_detached = false;
+	};
+}
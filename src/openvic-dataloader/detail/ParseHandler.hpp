@@ -6,6 +6,7 @@
 #include <utility>
 
 #include <openvic-dataloader/detail/Concepts.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
 
 #include <lexy/encoding.hpp>
 #include <lexy/input/buffer.hpp>
@@ -76,6 +77,11 @@ namespace ovdl::detail {
 			return _system_fallback_encoding.value_or(Encoding::Unknown);
 		}
 
+		/// Storage for the symbol buffers of buffers loaded afterwards, std::nullopt uses default_symbol_storage().
+		void set_symbol_storage(std::optional<symbol_storage> storage) {
+			_symbol_storage = storage;
+		}
+
 		virtual ~ParseHandler() = default;
 
 	protected:
@@ -83,6 +89,8 @@ namespace ovdl::detail {
 		constexpr virtual buffer_error load_buffer_impl(lexy::buffer<lexy::default_encoding>&& buffer, const char* path = "", std::optional<Encoding> fallback = std::nullopt) = 0;
 		virtual const char* path_impl() const = 0;
 
+		std::optional<symbol_storage> _symbol_storage;
+
 		template<detail::IsStateType State>
 		static constexpr auto generate_state = [](State* state, const char* path, auto&& buffer, Encoding encoding) {
 			if (path[0] != '\0') {
@@ -197,6 +205,7 @@ namespace ovdl::detail {
 				_parse_state = {};
 				return buffer_error::buffer_is_null;
 			}
+			symbol_storage_scope storage_scope { _symbol_storage };
 			create_state(&_parse_state, path, std::move(buffer), fallback);
 			return is_valid_impl() ? buffer_error::success : buffer_error::buffer_is_null;
 		}
@@ -228,6 +237,8 @@ namespace ovdl::detail {
 	template<detail::IsParseState ParseState>
 	struct BasicStateParseHandler : ParseHandler {
 		using parse_state_type = ParseState;
+		using symbol_interner_type = typename parse_state_type::ast_type::symbol_interner_type;
+		using concurrent_symbol_interner_type = typename parse_state_type::ast_type::concurrent_symbol_interner_type;
 
 		virtual constexpr bool is_valid_impl() const {
 			return _parse_state.ast().file().is_valid();
@@ -237,10 +248,30 @@ namespace ovdl::detail {
 			if (buffer.data() == nullptr) {
 				return buffer_error::buffer_is_null;
 			}
+			symbol_storage_scope storage_scope { _symbol_storage };
+			// A tree interning into a shared interner never uses its own, so it skips the file-sized reservation.
+			typename parse_state_type::ast_type::shared_symbol_interner_scope shared_scope {
+				_shared_symbol_interner != nullptr || _concurrent_symbol_interner != nullptr
+			};
 			create_state(&_parse_state, path, std::move(buffer), fallback);
+			if (_shared_symbol_interner != nullptr) {
+				_parse_state.ast().set_symbol_interner(_shared_symbol_interner);
+			} else if (_concurrent_symbol_interner != nullptr) {
+				_parse_state.ast().set_symbol_interner(_concurrent_symbol_interner);
+			}
 			return is_valid_impl() ? buffer_error::success : buffer_error::buffer_is_null;
 		}
 
+		/// Every buffer loaded afterwards interns its symbols into interner instead of a per-file one.
+		void set_shared_symbol_interner(symbol_interner_type* interner) {
+			_shared_symbol_interner = interner;
+			_concurrent_symbol_interner = nullptr;
+		}
+		void set_shared_symbol_interner(concurrent_symbol_interner_type* interner) {
+			_shared_symbol_interner = nullptr;
+			_concurrent_symbol_interner = interner;
+		}
+
 		virtual const char* path_impl() const {
 			return _parse_state.ast().file().path();
 		}
@@ -263,5 +294,7 @@ namespace ovdl::detail {
 
 	protected:
 		parse_state_type _parse_state;
+		symbol_interner_type* _shared_symbol_interner = nullptr;
+		concurrent_symbol_interner_type* _concurrent_symbol_interner = nullptr;
 	};
 }
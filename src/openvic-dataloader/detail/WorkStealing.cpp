@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <openvic-dataloader/detail/WorkStealing.hpp>
+
+using namespace ovdl::detail;
+
+namespace {
+	// Remaining share of one thread, begin in the high and end in the low 32 bits so both change atomically.
+	struct alignas(64) share {
+		std::atomic<std::uint64_t> range;
+	};
+
+	constexpr std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+		return (std::uint64_t(begin) << 32) | end;
+	}
+	constexpr std::uint32_t begin_of(std::uint64_t range) {
+		return std::uint32_t(range >> 32);
+	}
+	constexpr std::uint32_t end_of(std::uint64_t range) {
+		return std::uint32_t(range);
+	}
+
+	struct scheduler {
+		std::unique_ptr<share[]> shares;
+		std::size_t thread_count;
+		work_stealing_task_fn task;
+		void* context;
+
+		bool pop_front(std::size_t self, std::uint32_t& index) {
+			auto& range = shares[self].range;
+			auto current = range.load(std::memory_order_acquire);
+			while (begin_of(current) < end_of(current)) {
+				if (range.compare_exchange_weak(current, pack(begin_of(current) + 1, end_of(current)), std::memory_order_acq_rel)) {
+					index = begin_of(current);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Only the owner refills its own share, and only while it is empty, so thieves never race a refill.
+		bool steal(std::size_t self) {
+			while (true) {
+				std::size_t victim = thread_count;
+				std::uint64_t victim_range = 0;
+				std::uint32_t most = 0;
+				for (std::size_t i = 0; i < thread_count; ++i) {
+					if (i == self) {
+						continue;
+					}
+					auto range = shares[i].range.load(std::memory_order_acquire);
+					auto remaining = end_of(range) - std::min(begin_of(range), end_of(range));
+					if (remaining > most) {
+						most = remaining;
+						victim = i;
+						victim_range = range;
+					}
+				}
+				if (victim == thread_count) {
+					return false;
+				}
+
+				auto begin = begin_of(victim_range);
+				auto end = end_of(victim_range);
+				auto middle = begin + (end - begin) / 2;
+				if (shares[victim].range.compare_exchange_strong(victim_range, pack(begin, middle), std::memory_order_acq_rel)) {
+					shares[self].range.store(pack(middle, end), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+
+		void work(std::size_t self) {
+			std::uint32_t index;
+			do {
+				while (pop_front(self, index)) {
+					task(context, index);
+				}
+			} while (steal(self));
+		}
+	};
+}
+
+void ovdl::detail::run_work_stealing(std::size_t task_count, std::size_t thread_count, work_stealing_task_fn task, void* context) {
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	thread_count = std::min(thread_count, task_count);
+	if (thread_count <= 1) {
+		for (std::size_t i = 0; i < task_count; ++i) {
+			task(context, i);
+		}
+		return;
+	}
+
+	scheduler state { std::make_unique<share[]>(thread_count), thread_count, task, context };
+	for (std::size_t i = 0; i < thread_count; ++i) {
+		state.shares[i].range.store(pack(std::uint32_t(task_count * i / thread_count), std::uint32_t(task_count * (i + 1) / thread_count)), std::memory_order_relaxed);
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	for (std::size_t i = 1; i < thread_count; ++i) {
+		threads.emplace_back([&state, i] {
+			state.work(i);
+		});
+	}
+	state.work(0);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
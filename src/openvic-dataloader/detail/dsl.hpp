@@ -163,7 +163,7 @@ namespace ovdl::dsl {
 	template<typename ReturnType, ovdl::detail::string_literal Keyword>
 	static constexpr auto default_kw_value = dsl::callback<ReturnType*>(
 		[](detail::IsParseState auto& state, NodeLocation loc) {
-			return state.ast().template create<ReturnType>(loc, state.ast().intern(Keyword.data(), Keyword.size()));
+			return state.ast().template create<ReturnType>(loc, state.ast().intern_handle(Keyword.data(), Keyword.size()));
 		});
 
 	template<
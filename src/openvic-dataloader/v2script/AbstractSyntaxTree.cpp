@@ -1,3 +1,8 @@
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
 
 #include <lexy/dsl/option.hpp>
@@ -14,6 +19,7 @@ using namespace ovdl::v2script::ast;
 
 ListValue::ListValue(dryad::node_ctor ctor, StatementList statements)
 	: node_base(ctor) {
+	_statement_count = statements.count();
 	insert_child_list_after(nullptr, statements);
 	if (statements.empty()) {
 		_last_statement = nullptr;
@@ -23,6 +29,7 @@ ListValue::ListValue(dryad::node_ctor ctor, StatementList statements)
 }
 
 ListValue::ListValue(dryad::node_ctor ctor, AssignStatementList statements) : node_base(ctor) {
+	_statement_count = statements.count();
 	insert_child_list_after(nullptr, statements);
 	if (statements.empty()) {
 		_last_statement = nullptr;
@@ -36,6 +43,7 @@ ListValue::ListValue(dryad::node_ctor ctor) : node_base(ctor) {
 }
 
 FileTree::FileTree(dryad::node_ctor ctor, StatementList statements) : node_base(ctor) {
+	_statement_count = statements.count();
 	insert_child_list_after(nullptr, statements);
 	if (statements.empty()) {
 		_last_node = nullptr;
@@ -45,6 +53,7 @@ FileTree::FileTree(dryad::node_ctor ctor, StatementList statements) : node_base(
 }
 
 FileTree::FileTree(dryad::node_ctor ctor, AssignStatementList statements) : node_base(ctor) {
+	_statement_count = statements.count();
 	insert_child_list_after(nullptr, statements);
 	if (statements.empty()) {
 		_last_node = nullptr;
@@ -57,13 +66,47 @@ FileTree::FileTree(dryad::node_ctor ctor) : node_base(ctor) {
 	_last_node = nullptr;
 }
 
+std::span<const Statement* const> FileAbstractSyntaxTree::statement_array(const Node* list) const {
+	auto it = _statement_arrays.find(list);
+	if (it != _statement_arrays.end()) {
+		return it->second;
+	}
+
+	std::vector<const Statement*> statements;
+	auto collect = [&](const auto* node) {
+		statements.reserve(node->statement_count());
+		for (const auto* statement : node->statements()) {
+			statements.push_back(statement);
+		}
+	};
+	if (auto* list_value = dryad::node_try_cast<ListValue>(list)) {
+		collect(list_value);
+	} else if (auto* file_tree = dryad::node_try_cast<FileTree>(list)) {
+		collect(file_tree);
+	}
+	return _statement_arrays.emplace(list, std::move(statements)).first->second;
+}
+
+const KeyIndex& FileAbstractSyntaxTree::key_index(const Node* list) const {
+	auto it = _key_indices.find(list);
+	if (it == _key_indices.end()) {
+		it = _key_indices.emplace(list, KeyIndex(list)).first;
+	}
+	return it->second;
+}
+
 std::string FileAbstractSyntaxTree::make_list_visualizer() const {
 	const int INDENT_SIZE = 2;
 
 	std::string result;
 	unsigned int level = 0;
 
-	for (auto [event, node] : dryad::traverse(this->_tree)) {
+	if (root() == nullptr) {
+		return result;
+	}
+
+	// The root rather than the tree, nodes of forest parses live in the forest's arena.
+	for (auto [event, node] : dryad::traverse(root())) {
 		if (event == dryad::traverse_event::exit) {
 			--level;
 			continue;
@@ -75,7 +118,7 @@ std::string FileAbstractSyntaxTree::make_list_visualizer() const {
 		dryad::visit_node(
 			node,
 			[&](const FlatValue* value) {
-				result.append(value->value().c_str());
+				result.append(value->value(*this).c_str());
 			},
 			[&](const ListValue* value) {
 			},
@@ -105,13 +148,17 @@ std::string FileAbstractSyntaxTree::make_native_visualizer() const {
 	std::string result;
 	unsigned int level = 0;
 
+	if (root() == nullptr) {
+		return result;
+	}
+
 	dryad::visit_tree(
-		this->_tree,
+		root(),
 		[&](const IdentifierValue* value) {
-			result.append(value->value().c_str());
+			result.append(value->value(*this).c_str());
 		},
 		[&](const StringValue* value) {
-			result.append(1, '"').append(value->value().c_str()).append(1, '"');
+			result.append(1, '"').append(value->value(*this).c_str()).append(1, '"');
 		},
 		[&](dryad::child_visitor<NodeKind> visitor, const ValueStatement* statement) {
 			visitor(statement->value());
@@ -0,0 +1,99 @@
+#include "openvic-dataloader/v2script/DetachedFile.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+#include "ParseState.hpp"
+
+using namespace ovdl;
+using namespace ovdl::v2script;
+
+struct DetachedFile::Data {
+	ast::FileAbstractSyntaxTree ast;
+	std::string path;
+};
+
+DetachedFile::DetachedFile() = default;
+DetachedFile::DetachedFile(DetachedFile&&) = default;
+DetachedFile& DetachedFile::operator=(DetachedFile&&) = default;
+DetachedFile::~DetachedFile() = default;
+
+DetachedFile::DetachedFile(ast::FileAbstractSyntaxTree&& ast, std::string_view path)
+	: _data(std::make_unique<Data>(Data { std::move(ast), std::string(path) })) {
+	_data->ast.file().release_buffer();
+}
+
+bool DetachedFile::has_file_node() const {
+	return get_file_node() != nullptr;
+}
+
+std::string_view DetachedFile::get_file_path() const {
+	return _data ? std::string_view(_data->path) : std::string_view();
+}
+
+const ast::FileTree* DetachedFile::get_file_node() const {
+	return _data ? _data->ast.root() : nullptr;
+}
+
+std::string_view DetachedFile::value(const ast::FlatValue* node) const {
+	return node->value(_data->ast).view();
+}
+
+SymbolIntern::symbol_handle_type DetachedFile::find_handle(std::string_view string) const {
+	if (!_data) {
+		return SymbolIntern::symbol_handle_type();
+	}
+	return _data->ast.find_handle(string.data(), string.size());
+}
+
+const SymbolIntern::symbol_interner_type& DetachedFile::symbol_interner() const {
+	return _data->ast.symbol_interner();
+}
+
+SymbolResolver DetachedFile::symbol_resolver() const {
+	return _data->ast.symbol_resolver();
+}
+
+std::span<const ast::Statement* const> DetachedFile::statement_array(const ast::Node* list) const {
+	if (list == nullptr || !_data) {
+		return {};
+	}
+	return _data->ast.statement_array(list);
+}
+
+const ast::AssignStatement* DetachedFile::find(const ast::Node* list, SymbolIntern::symbol_handle_type key) const {
+	auto statements = find_all(list, key);
+	return statements.empty() ? nullptr : statements.front();
+}
+
+const ast::AssignStatement* DetachedFile::find(const ast::Node* list, std::string_view key) const {
+	return find(list, find_handle(key));
+}
+
+std::span<const ast::AssignStatement* const> DetachedFile::find_all(const ast::Node* list, SymbolIntern::symbol_handle_type key) const {
+	if (list == nullptr || !key || !_data) {
+		return {};
+	}
+	return _data->ast.key_index(list).find_all(key);
+}
+
+std::span<const ast::AssignStatement* const> DetachedFile::find_all(const ast::Node* list, std::string_view key) const {
+	return find_all(list, find_handle(key));
+}
+
+const FilePosition DetachedFile::get_position(const ast::Node* node) const {
+	if (!node || !node->is_linked_in_tree() || !_data) {
+		return {};
+	}
+
+	const auto& ast = _data->ast;
+	return ast.file().position_of(ast.file().compact_location_of(node));
+}
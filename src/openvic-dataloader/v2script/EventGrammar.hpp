@@ -1,6 +1,5 @@
 #pragma once
 
-#include <cctype>
 #include <cstdlib>
 
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
@@ -29,14 +28,9 @@ namespace ovdl::v2script::grammar {
 			static constexpr auto rule = lexy::dsl::p<Identifier>;
 			static constexpr auto value = dsl::callback<ast::IdentifierValue*>(
 				[](detail::IsParseState auto& state, ast::IdentifierValue* value) {
-					bool is_number = true;
-					for (auto* current = value->value().c_str(); *current; current++) {
-						is_number = is_number && std::isdigit(*current);
-						if (!is_number) {
-							break;
-						}
-					}
-					if (!is_number) {
+					// Digits only: signs warn, digit runs too long for an integer do not.
+					auto text = value->value(state.ast()).view();
+					if (value->value_class() != ast::FlatValueClass::Integer || text.front() == '+' || text.front() == '-') {
 						state.logger().warning("month is not an integer") //
 							.primary(state.ast().location_of(value), "here")
 							.finish();
@@ -97,16 +91,17 @@ namespace ovdl::v2script::grammar {
 		static constexpr auto value =
 			dsl::callback<ast::EventStatement*>(
 				[](detail::IsParseState auto& state, NodeLocation loc, ast::IdentifierValue* name, ast::ListValue* list) {
-					auto country_decl = state.ast().intern("country_event");
-					auto province_decl = state.ast().intern("province_event");
+					auto country_decl = state.ast().intern_handle("country_event");
+					auto province_decl = state.ast().intern_handle("province_event");
 
-					if (name->value() != country_decl || name->value() != province_decl) {
-						state.logger().warning("event declarator \"{}\" is not {} or {}", name->value().c_str(), country_decl.c_str(), province_decl.c_str()) //
+					if (name->handle() != country_decl || name->handle() != province_decl) {
+						const auto& symbols = state.ast();
+						state.logger().warning("event declarator \"{}\" is not {} or {}", name->value(symbols).c_str(), country_decl.c_str(symbols), province_decl.c_str(symbols)) //
 							.primary(loc, "here")
 							.finish();
 					}
 
-					return state.ast().template create<ast::EventStatement>(loc, name->value() == province_decl, list);
+					return state.ast().template create<ast::EventStatement>(loc, name->handle() == province_decl, list);
 				});
 	};
 
@@ -0,0 +1,62 @@
+#include <cassert>
+#include <utility>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/FlatTree.hpp>
+
+#include <dryad/node.hpp>
+
+using namespace ovdl::v2script::ast;
+
+void FlatTree::Builder::open(NodeKind kind, const Node* source, bool is_province_event) {
+	_open.push_back(index_type(_nodes.size()));
+	_nodes.push_back({ .kind = kind, .is_province_event = is_province_event });
+	_sources.push_back(source);
+}
+
+void FlatTree::Builder::close() {
+	assert(!_open.empty());
+	auto index = _open.back();
+	_open.pop_back();
+	_nodes[index].subtree_size = index_type(_nodes.size() - index);
+}
+
+void FlatTree::Builder::leaf(NodeKind kind, SymbolIntern::symbol_handle_type handle, const Node* source) {
+	_nodes.push_back({ .kind = kind, .handle = handle });
+	_sources.push_back(source);
+}
+
+FlatTree FlatTree::Builder::finish() && {
+	assert(_open.empty() && "every opened node must be closed");
+
+	FlatTree result;
+	result._nodes = std::move(_nodes);
+	result._sources = std::move(_sources);
+	return result;
+}
+
+FlatTree::FlatTree(const Node* root) {
+	if (root == nullptr) {
+		return;
+	}
+
+	Builder builder;
+	for (auto [event, node] : dryad::traverse(root)) {
+		if (event == dryad::traverse_event::exit) {
+			builder.close();
+			continue;
+		}
+
+		if (auto* value = dryad::node_try_cast<FlatValue>(node)) {
+			builder.leaf(node->kind(), value->handle(), node);
+		} else if (event == dryad::traverse_event::leaf) {
+			builder.leaf(node->kind(), {}, node);
+		} else if (auto* statement = dryad::node_try_cast<EventStatement>(node)) {
+			builder.open(node->kind(), node, statement->is_province_event());
+		} else {
+			builder.open(node->kind(), node);
+		}
+	}
+
+	*this = std::move(builder).finish();
+}
@@ -0,0 +1,79 @@
+#include "openvic-dataloader/v2script/Forest.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+
+#include "v2script/ForestData.hpp"
+
+using namespace ovdl;
+using namespace ovdl::v2script;
+
+Forest::Forest()
+	: _data(std::make_unique<ForestData>()) {}
+
+Forest::Forest(SymbolIntern::symbol_interner_type& symbol_interner)
+	: _data(std::make_unique<ForestData>(symbol_interner)) {}
+
+Forest::Forest(Forest&&) = default;
+Forest& Forest::operator=(Forest&&) = default;
+Forest::~Forest() = default;
+
+std::size_t Forest::size() const {
+	return _data->files.size();
+}
+
+bool Forest::empty() const {
+	return _data->files.empty();
+}
+
+std::span<const ast::FileTree* const> Forest::file_nodes() const {
+	return _data->roots;
+}
+
+const ast::FileTree* Forest::file_node(std::size_t index) const {
+	return _data->files[index].root;
+}
+
+std::string_view Forest::file_path(std::size_t index) const {
+	return _data->files[index].path;
+}
+
+std::string_view Forest::value(const ast::FlatValue* node) const {
+	return node->value(*_data->symbol_interner).view();
+}
+
+SymbolIntern::symbol_handle_type Forest::find_handle(std::string_view string) const {
+	return _data->symbol_interner->find_handle(string.data(), string.size());
+}
+
+const SymbolIntern::symbol_interner_type& Forest::symbol_interner() const {
+	return *_data->symbol_interner;
+}
+
+const FilePosition Forest::get_position(const ast::Node* node) const {
+	const auto* slot = node ? ast::location_slot(node) : nullptr;
+	if (slot == nullptr) {
+		return {};
+	}
+
+	const auto* file = _data->file_of(slot->location_index());
+	const auto* location = _data->locations.find(*slot);
+	if (file == nullptr || location == nullptr || location->is_synthesized()) {
+		return {};
+	}
+
+	auto begin = file->lines.resolve(location->begin_offset());
+	FilePosition result { begin.line, begin.line, begin.column, begin.column };
+	if (location->begin_offset() < location->end_offset()) {
+		auto end = file->lines.resolve(location->end_offset());
+		result.end_line = end.line;
+		result.end_column = end.column;
+	}
+	return result;
+}
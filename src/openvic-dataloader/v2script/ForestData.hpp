@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/NodeLocation.hpp>
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/Forest.hpp>
+
+#include <dryad/tree.hpp>
+
+#include "detail/LineIndex.hpp"
+
+namespace ovdl::v2script {
+	struct ForestData {
+		struct File {
+			const ast::FileTree* root;
+			std::string path;
+			detail::LineIndex lines;
+			/// Range of the file's indices in locations, parses allocate their slots consecutively.
+			std::uint32_t first_location;
+			std::uint32_t end_location;
+		};
+
+		// Chunked storage reserves nothing, so the own interner costs nothing when an external one is used.
+		ForestData()
+			: own_symbol_interner(0, symbol_storage::chunked),
+			  symbol_interner(&own_symbol_interner) {}
+
+		explicit ForestData(SymbolIntern::symbol_interner_type& symbol_interner)
+			: own_symbol_interner(0, symbol_storage::chunked),
+			  symbol_interner(&symbol_interner) {}
+
+		void add_file(const ast::FileTree* root, std::string_view path, detail::LineIndex&& lines, std::uint32_t first_location) {
+			files.push_back({ root, std::string(path), std::move(lines), first_location, std::uint32_t(locations.size()) });
+			roots.push_back(root);
+		}
+
+		const File* file_of(std::uint32_t location_index) const {
+			auto it = std::upper_bound(files.begin(), files.end(), location_index, [](std::uint32_t index, const File& file) {
+				return index < file.first_location;
+			});
+			if (it == files.begin() || location_index >= std::prev(it)->end_location) {
+				return nullptr;
+			}
+			return &*std::prev(it);
+		}
+
+		dryad::tree<ast::FileTree> nodes;
+		NodeLocationTable locations;
+		SymbolIntern::symbol_interner_type own_symbol_interner;
+		SymbolIntern::symbol_interner_type* symbol_interner;
+		std::vector<File> files;
+		std::vector<const ast::FileTree*> roots;
+	};
+}
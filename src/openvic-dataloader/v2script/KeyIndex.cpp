@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/KeyIndex.hpp>
+
+#include <dryad/node.hpp>
+
+using namespace ovdl::v2script::ast;
+
+using keyed_statements = std::vector<std::pair<SymbolIntern::symbol_handle_type, const AssignStatement*>>;
+
+static void collect_keyed(const Statement* statement, keyed_statements& keyed) {
+	auto* assign = dryad::node_try_cast<AssignStatement>(statement);
+	if (assign == nullptr) {
+		return;
+	}
+	auto* key = dryad::node_try_cast<FlatValue>(assign->left());
+	if (key != nullptr && key->handle()) {
+		keyed.emplace_back(key->handle(), assign);
+	}
+}
+
+KeyIndex::KeyIndex(const Node* list) {
+	keyed_statements keyed;
+
+	auto collect = [&](const auto* node) {
+		keyed.reserve(node->statement_count());
+		for (const auto* statement : node->statements()) {
+			collect_keyed(statement, keyed);
+		}
+	};
+
+	if (auto* list_value = dryad::node_try_cast<ListValue>(list)) {
+		collect(list_value);
+	} else if (auto* file_tree = dryad::node_try_cast<FileTree>(list)) {
+		collect(file_tree);
+	}
+
+	_group(keyed);
+}
+
+KeyIndex::KeyIndex(std::span<const Statement* const> statements) {
+	keyed_statements keyed;
+	keyed.reserve(statements.size());
+	for (const auto* statement : statements) {
+		collect_keyed(statement, keyed);
+	}
+
+	_group(keyed);
+}
+
+void KeyIndex::_group(std::vector<std::pair<SymbolIntern::symbol_handle_type, const AssignStatement*>>& keyed) {
+	// Stable so duplicate keys stay in source order.
+	std::stable_sort(keyed.begin(), keyed.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.first.id() < rhs.first.id();
+	});
+
+	_statements.reserve(keyed.size());
+	for (const auto& [key, statement] : keyed) {
+		auto& range = *_ranges.try_emplace(key, statement_range { std::uint32_t(_statements.size()), 0 }).first;
+		range.count++;
+		_statements.push_back(statement);
+	}
+}
@@ -33,8 +33,9 @@ namespace ovdl::v2script::lua::grammar {
 		static constexpr auto value =
 			callback<ast::IdentifierValue*>(
 				[](detail::IsParseState auto& state, auto lexeme) {
-					auto value = state.ast().intern(lexeme.data(), lexeme.size());
-					return state.ast().template create<ast::IdentifierValue>(lexeme.begin(), lexeme.end(), value);
+					auto value = state.ast().intern_handle(lexeme.data(), lexeme.size());
+					auto value_class = ast::classify_flat_value(std::string_view(lexeme.data(), lexeme.size()));
+					return state.ast().template create<ast::IdentifierValue>(lexeme.begin(), lexeme.end(), value, value_class);
 				});
 	};
 
@@ -43,8 +44,9 @@ namespace ovdl::v2script::lua::grammar {
 		static constexpr auto value =
 			callback<ast::IdentifierValue*>(
 				[](detail::IsParseState auto& state, auto lexeme) {
-					auto value = state.ast().intern(lexeme.data(), lexeme.size());
-					return state.ast().template create<ast::IdentifierValue>(lexeme.begin(), lexeme.end(), value);
+					auto value = state.ast().intern_handle(lexeme.data(), lexeme.size());
+					auto value_class = ast::classify_flat_value(std::string_view(lexeme.data(), lexeme.size()));
+					return state.ast().template create<ast::IdentifierValue>(lexeme.begin(), lexeme.end(), value, value_class);
 				});
 	};
 
@@ -55,8 +57,8 @@ namespace ovdl::v2script::lua::grammar {
 			dsl::as_string_view<> >>
 			dsl::callback<ast::StringValue*>(
 				[](detail::IsParseState auto& state, std::string_view sv) {
-					auto value = state.ast().intern(sv);
-					return state.ast().template create<ast::StringValue>(ovdl::NodeLocation::make_from(sv.data(), sv.data() + sv.size()), value);
+					auto value = state.ast().intern_handle(sv);
+					return state.ast().template create<ast::StringValue>(ovdl::NodeLocation::make_from(sv.data(), sv.data() + sv.size()), value, ast::classify_flat_value(sv));
 				});
 	};
 
@@ -20,7 +20,7 @@ namespace ovdl::v2script::grammar {
 		static constexpr auto rule = lexy::dsl::position(factor_keyword) >> (lexy::dsl::equal_sign + lexy::dsl::p<Identifier>);
 		static constexpr auto value = dsl::callback<ast::AssignStatement*>(
 			[](detail::IsParseState auto& state, NodeLocation loc, ast::IdentifierValue* value) {
-				auto* factor = state.ast().template create<ast::IdentifierValue>(loc, state.ast().intern("factor"));
+				auto* factor = state.ast().template create<ast::IdentifierValue>(loc, state.ast().intern_handle("factor"));
 				return state.ast().template create<ast::AssignStatement>(loc, factor, value);
 			});
 	};
@@ -47,7 +47,7 @@ namespace ovdl::v2script::grammar {
 
 		static constexpr auto value = dsl::callback<ast::AssignStatement*>(
 			[](detail::IsParseState auto& state, NodeLocation loc, ast::ListValue* list) {
-				auto* factor = state.ast().template create<ast::IdentifierValue>(loc, state.ast().intern("modifier"));
+				auto* factor = state.ast().template create<ast::IdentifierValue>(loc, state.ast().intern_handle("modifier"));
 				return state.ast().template create<ast::AssignStatement>(loc, factor, list);
 			});
 	};
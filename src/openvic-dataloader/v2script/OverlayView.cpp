@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolMap.hpp>
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/KeyIndex.hpp>
+#include <openvic-dataloader/v2script/OverlayView.hpp>
+
+#include <dryad/node.hpp>
+
+using namespace ovdl;
+using namespace ovdl::v2script::ast;
+
+static SymbolIntern::symbol_handle_type key_of(const Statement* statement) {
+	auto* assign = dryad::node_try_cast<AssignStatement>(statement);
+	auto* key = assign ? dryad::node_try_cast<FlatValue>(assign->left()) : nullptr;
+	return key ? key->handle() : SymbolIntern::symbol_handle_type();
+}
+
+template<typename Callback>
+static void for_each_statement(const Node* list, Callback&& callback) {
+	if (auto* list_value = dryad::node_try_cast<ListValue>(list)) {
+		for (const auto* statement : list_value->statements()) {
+			callback(statement);
+		}
+	} else if (auto* file_tree = dryad::node_try_cast<FileTree>(list)) {
+		for (const auto* statement : file_tree->statements()) {
+			callback(statement);
+		}
+	}
+}
+
+static std::size_t statement_count_of(const Node* list) {
+	if (auto* list_value = dryad::node_try_cast<ListValue>(list)) {
+		return list_value->statement_count();
+	}
+	if (auto* file_tree = dryad::node_try_cast<FileTree>(list)) {
+		return file_tree->statement_count();
+	}
+	return 0;
+}
+
+OverlayView::OverlayView(std::span<const Node* const> layers, const MergeRules& rules) {
+	// The highest layer assigning each replaced key, the only one whose assignments to it are kept.
+	symbol_map<std::uint32_t> replacing_layers;
+	std::size_t statement_count = 0;
+	for (std::uint32_t layer = 0; layer < layers.size(); ++layer) {
+		statement_count += statement_count_of(layers[layer]);
+		for_each_statement(layers[layer], [&](const Statement* statement) {
+			auto key = key_of(statement);
+			if (key && rules.mode_of(key) == MergeMode::Replace) {
+				replacing_layers[key] = layer;
+			}
+		});
+	}
+
+	_statements.reserve(statement_count);
+	_layers.reserve(statement_count);
+	for (std::uint32_t layer = 0; layer < layers.size(); ++layer) {
+		for_each_statement(layers[layer], [&](const Statement* statement) {
+			if (auto key = key_of(statement)) {
+				auto* replacing_layer = replacing_layers.find(key);
+				if (replacing_layer != nullptr && *replacing_layer != layer) {
+					return;
+				}
+			}
+			_statements.push_back(statement);
+			_layers.push_back(layer);
+		});
+	}
+
+	_keys = KeyIndex(std::span<const Statement* const>(_statements));
+}
@@ -0,0 +1,33 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/ParallelVisit.hpp>
+
+#include <dryad/node.hpp>
+
+using namespace ovdl::v2script::ast;
+
+std::vector<StatementChunk> ovdl::v2script::ast::partition_statements(StatementChunk statements, std::size_t nodes_per_chunk) {
+	nodes_per_chunk = std::max<std::size_t>(nodes_per_chunk, 1);
+
+	std::vector<StatementChunk> result;
+	std::size_t chunk_begin = 0;
+	std::size_t chunk_nodes = 0;
+	for (std::size_t i = 0; i < statements.size(); ++i) {
+		for (auto [event, node] : dryad::traverse(statements[i])) {
+			chunk_nodes += event != dryad::traverse_event::exit;
+		}
+
+		if (chunk_nodes >= nodes_per_chunk) {
+			result.push_back(statements.subspan(chunk_begin, i + 1 - chunk_begin));
+			chunk_begin = i + 1;
+			chunk_nodes = 0;
+		}
+	}
+	if (chunk_begin < statements.size()) {
+		result.push_back(statements.subspan(chunk_begin));
+	}
+	return result;
+}
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <span>
+#include <unordered_map>
+#include <vector>
+
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/KeyIndex.hpp>
 
 #include <lexy/encoding.hpp>
 
@@ -16,6 +21,24 @@ namespace ovdl::v2script::ast {
 
 		std::string make_list_visualizer() const;
 		std::string make_native_visualizer() const;
+
+		/// Statements of list, a ListValue or FileTree, copied into a contiguous array on first use and cached
+		/// until the root changes. Not safe to call from several threads at once.
+		std::span<const Statement* const> statement_array(const Node* list) const;
+
+		/// KeyIndex of list, built on its first lookup and cached until the root changes.
+		/// Not safe to call from several threads at once.
+		const KeyIndex& key_index(const Node* list) const;
+
+		void set_root(FileTree* node) {
+			_statement_arrays.clear();
+			_key_indices.clear();
+			BasicAbstractSyntaxTree::set_root(node);
+		}
+
+	private:
+		mutable std::unordered_map<const Node*, std::vector<const Statement*>> _statement_arrays;
+		mutable std::unordered_map<const Node*, KeyIndex> _key_indices;
 	};
 
 	using ParseState = ovdl::ParseState<FileAbstractSyntaxTree>;
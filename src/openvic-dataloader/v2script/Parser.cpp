@@ -1,10 +1,13 @@
 #include "openvic-dataloader/v2script/Parser.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <optional>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <openvic-dataloader/Error.hpp>
 #include <openvic-dataloader/NodeLocation.hpp>
@@ -14,6 +17,10 @@
 #include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/detail/Utility.hpp>
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/DetachedFile.hpp>
+#include <openvic-dataloader/v2script/FlatTree.hpp>
+#include <openvic-dataloader/v2script/Forest.hpp>
+#include <openvic-dataloader/v2script/PathQuery.hpp>
 
 #include <lexy/action/parse.hpp>
 #include <lexy/encoding.hpp>
@@ -34,6 +41,7 @@
 #include "detail/Warnings.hpp"
 #include "v2script/DecisionGrammar.hpp"
 #include "v2script/EventGrammar.hpp"
+#include "v2script/ForestData.hpp"
 #include "v2script/LuaDefinesGrammar.hpp"
 #include "v2script/SimpleGrammar.hpp"
 
@@ -75,9 +83,31 @@ struct Parser::ParseHandler final : detail::BasicStateParseHandler<v2script::ast
 			return parse_state().logger().get_errors();
 		}
 		parse_state().ast().set_root(result.value());
+		if (_forest != nullptr) {
+			_forest->add_file(result.value(), path(), parse_state().ast().file().make_detached_line_index(), _first_forest_location);
+		}
 		return std::nullopt;
 	}
 
+	constexpr detail::buffer_error load_buffer_impl(lexy::buffer<lexy::default_encoding>&& buffer, const char* path, std::optional<detail::Encoding> fallback) override {
+		auto error = BasicStateParseHandler::load_buffer_impl(std::move(buffer), path, fallback);
+		if (_forest != nullptr && error == detail::buffer_error::success) {
+			parse_state().ast().set_node_arena(&_forest->nodes);
+			parse_state().ast().file().set_location_table(&_forest->locations);
+			_first_forest_location = std::uint32_t(_forest->locations.size());
+		}
+		return error;
+	}
+
+	void set_forest(ForestData* forest) {
+		_forest = forest;
+		set_shared_symbol_interner(forest != nullptr ? forest->symbol_interner : nullptr);
+	}
+
+	bool has_forest() const {
+		return _forest != nullptr;
+	}
+
 	ast::FileTree* root() {
 		return parse_state().ast().root();
 	}
@@ -85,6 +115,10 @@ struct Parser::ParseHandler final : detail::BasicStateParseHandler<v2script::ast
 	Parser::error_range get_errors() {
 		return parse_state().logger().get_errors();
 	}
+
+private:
+	ForestData* _forest = nullptr;
+	std::uint32_t _first_forest_location = 0;
 };
 
 ///	ParseHandler ///
@@ -99,6 +133,46 @@ Parser::Parser(std::basic_ostream<char>& error_stream)
 	set_error_log_to(error_stream);
 }
 
+Parser::Parser(SymbolIntern::symbol_interner_type& symbol_interner)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_shared_symbol_interner(&symbol_interner);
+	set_error_log_to_null();
+}
+
+Parser::Parser(SymbolIntern::symbol_interner_type& symbol_interner, std::basic_ostream<char>& error_stream)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_shared_symbol_interner(&symbol_interner);
+	set_error_log_to(error_stream);
+}
+
+Parser::Parser(ConcurrentSymbolIntern::symbol_interner_type& symbol_interner)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_shared_symbol_interner(&symbol_interner);
+	set_error_log_to_null();
+}
+
+Parser::Parser(ConcurrentSymbolIntern::symbol_interner_type& symbol_interner, std::basic_ostream<char>& error_stream)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_shared_symbol_interner(&symbol_interner);
+	set_error_log_to(error_stream);
+}
+
+Parser::Parser(Forest& forest)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_forest(forest._data.get());
+	set_error_log_to_null();
+}
+
+Parser::Parser(Forest& forest, std::basic_ostream<char>& error_stream)
+	: _parse_handler(std::make_unique<ParseHandler>()) {
+	_parse_handler->set_forest(forest._data.get());
+	set_error_log_to(error_stream);
+}
+
+void Parser::set_symbol_storage(symbol_storage storage) {
+	_parse_handler->set_symbol_storage(storage);
+}
+
 Parser::Parser(Parser&&) = default;
 Parser& Parser::operator=(Parser&&) = default;
 Parser::~Parser() = default;
@@ -269,15 +343,82 @@ const FileTree* Parser::get_file_node() const {
 	return _parse_handler->root();
 }
 
+ast::FlatTree Parser::make_flat_tree() const {
+	return ast::FlatTree(get_file_node());
+}
+
 std::string_view Parser::value(const ovdl::v2script::ast::FlatValue* node) const {
-	return node->value().view();
+	return node->value(_parse_handler->parse_state().ast()).view();
 }
 
 ovdl::symbol<char> Parser::find_intern(std::string_view string) const {
 	if (!_parse_handler->is_valid()) {
 		return ovdl::symbol<char>();
 	}
-	return _parse_handler->parse_state().ast().symbol_interner().find_intern(string.data(), string.size());
+	return _parse_handler->parse_state().ast().find_intern(string.data(), string.size());
+}
+
+SymbolIntern::symbol_handle_type Parser::find_handle(std::string_view string) const {
+	if (!_parse_handler->is_valid()) {
+		return SymbolIntern::symbol_handle_type();
+	}
+	return _parse_handler->parse_state().ast().find_handle(string.data(), string.size());
+}
+
+std::span<const ast::Statement* const> Parser::statement_array(const ast::Node* list) const {
+	if (list == nullptr || !_parse_handler->is_valid()) {
+		return {};
+	}
+	return _parse_handler->parse_state().ast().statement_array(list);
+}
+
+const ast::Statement* Parser::statement_at(const ast::Node* list, std::size_t index) const {
+	auto statements = statement_array(list);
+	return index < statements.size() ? statements[index] : nullptr;
+}
+
+ast::PathQuery Parser::compile_query(std::string_view path) const {
+	return ast::PathQuery::compile(path, [this](std::string_view key) {
+		return find_handle(key);
+	});
+}
+
+ast::PathQuery::Cursor Parser::query(const ast::PathQuery& query, const ast::Node* root) const {
+	static constexpr ast::PathQuery::statements_fn statements = [](const void* context, const ast::Node* list) {
+		return static_cast<const Parser*>(context)->statement_array(list);
+	};
+
+	ast::PathQuery::Cursor result(query, statements, this);
+	result.reset(root != nullptr ? root : get_file_node());
+	return result;
+}
+
+const ast::AssignStatement* Parser::find(const ast::Node* list, SymbolIntern::symbol_handle_type key) const {
+	auto statements = find_all(list, key);
+	return statements.empty() ? nullptr : statements.front();
+}
+
+const ast::AssignStatement* Parser::find(const ast::Node* list, std::string_view key) const {
+	return find(list, find_handle(key));
+}
+
+std::span<const ast::AssignStatement* const> Parser::find_all(const ast::Node* list, SymbolIntern::symbol_handle_type key) const {
+	if (list == nullptr || !key || !_parse_handler->is_valid()) {
+		return {};
+	}
+	return _parse_handler->parse_state().ast().key_index(list).find_all(key);
+}
+
+std::span<const ast::AssignStatement* const> Parser::find_all(const ast::Node* list, std::string_view key) const {
+	return find_all(list, find_handle(key));
+}
+
+const SymbolIntern::symbol_interner_type& Parser::symbol_interner() const {
+	return _parse_handler->parse_state().ast().symbol_interner();
+}
+
+SymbolResolver Parser::symbol_resolver() const {
+	return _parse_handler->parse_state().ast().symbol_resolver();
 }
 
 std::string Parser::make_native_string() const {
@@ -293,22 +434,21 @@ const FilePosition Parser::get_position(const ast::Node* node) const {
 		return {};
 	}
 
-	NodeLocation node_location;
+	const auto& ast = _parse_handler->parse_state().ast();
+	return ast.file().position_of(ast.location_of(node));
+}
 
-	node_location = _parse_handler->parse_state().ast().location_of(node);
+std::vector<FilePosition> Parser::get_positions(std::span<const ast::Node* const> nodes) const {
+	const auto& ast = _parse_handler->parse_state().ast();
 
-	if (node_location.is_synthesized()) {
-		return FilePosition {};
+	std::vector<NodeLocation> locations;
+	locations.reserve(nodes.size());
+	for (const auto* node : nodes) {
+		locations.push_back(node && node->is_linked_in_tree() ? ast.location_of(node) : NodeLocation {});
 	}
 
-	lexy::buffer<lexy::utf8_char_encoding, void> const& buffer = _parse_handler->buffer();
-	auto loc_begin = lexy::get_input_location(buffer, node_location.begin());
-	FilePosition result { loc_begin.line_nr(), loc_begin.line_nr(), loc_begin.column_nr(), loc_begin.column_nr() };
-	if (node_location.begin() < node_location.end()) {
-		auto loc_end = lexy::get_input_location(buffer, node_location.end(), loc_begin.anchor());
-		result.end_line = loc_end.line_nr();
-		result.end_column = loc_end.column_nr();
-	}
+	std::vector<FilePosition> result(nodes.size());
+	ast.file().positions_of(locations, result);
 	return result;
 }
 
@@ -325,19 +465,18 @@ const FilePosition Parser::get_error_position(const error::Error* error) const {
 		return {};
 	}
 
-	auto err_location = _parse_handler->parse_state().logger().location_of(error);
-	if (err_location.is_synthesized()) {
-		return FilePosition {};
-	}
+	const auto& parse_state = _parse_handler->parse_state();
+	return parse_state.ast().file().position_of(parse_state.logger().location_of(error));
+}
 
-	lexy::buffer<lexy::utf8_char_encoding, void> const& buffer = _parse_handler->buffer();
-	auto loc_begin = lexy::get_input_location(buffer, err_location.begin());
-	FilePosition result { loc_begin.line_nr(), loc_begin.line_nr(), loc_begin.column_nr(), loc_begin.column_nr() };
-	if (err_location.begin() < err_location.end()) {
-		auto loc_end = lexy::get_input_location(buffer, err_location.end(), loc_begin.anchor());
-		result.end_line = loc_end.line_nr();
-		result.end_column = loc_end.column_nr();
+DetachedFile Parser::detach() {
+	if (!_parse_handler->is_valid() || !get_file_node() || _parse_handler->has_forest()) {
+		return {};
 	}
+
+	auto& parse_state = _parse_handler->parse_state();
+	DetachedFile result(std::move(parse_state.ast()), _parse_handler->path());
+	parse_state = {};
 	return result;
 }
 
@@ -0,0 +1,59 @@
+#include <cassert>
+#include <cstddef>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/PathQuery.hpp>
+
+#include <dryad/node.hpp>
+
+using namespace ovdl::v2script::ast;
+
+bool PathQuery::matches(std::size_t depth, const AssignStatement* statement) const {
+	assert(depth < _steps.size());
+	const auto& step = _steps[depth];
+	if (step.is_wildcard) {
+		return true;
+	}
+
+	auto* key = dryad::node_try_cast<FlatValue>(statement->left());
+	return key != nullptr && key->handle() == step.key;
+}
+
+PathQuery::Cursor::Cursor(const PathQuery& query, statements_fn statements, const void* context)
+	: _query(&query),
+	  _statements(statements),
+	  _context(context) {
+	_frames.reserve(query._steps.size());
+}
+
+void PathQuery::Cursor::reset(const Node* root) {
+	_frames.clear();
+	if (root != nullptr && _query->can_match()) {
+		_frames.push_back({ _statements(_context, root) });
+	}
+}
+
+const AssignStatement* PathQuery::Cursor::next() {
+	while (!_frames.empty()) {
+		auto& frame = _frames.back();
+		if (frame.index == frame.statements.size()) {
+			_frames.pop_back();
+			continue;
+		}
+
+		auto depth = _frames.size() - 1;
+		auto* statement = dryad::node_try_cast<AssignStatement>(frame.statements[frame.index++]);
+		if (statement == nullptr || !_query->matches(depth, statement)) {
+			continue;
+		}
+
+		if (depth + 1 == _query->_steps.size()) {
+			return statement;
+		}
+		if (auto* list = dryad::node_try_cast<ListValue>(statement->right())) {
+			// Stays within the capacity reserved for one frame per step.
+			_frames.push_back({ _statements(_context, list) });
+		}
+	}
+	return nullptr;
+}
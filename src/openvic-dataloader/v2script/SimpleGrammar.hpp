@@ -74,8 +74,9 @@ namespace ovdl::v2script::grammar {
 
 		static constexpr auto value = dsl::callback<ast::IdentifierValue*>(
 			[](detail::IsParseState auto& state, auto lexeme) {
-				auto value = state.ast().intern(lexeme);
-				return state.ast().template create<ast::IdentifierValue>(ovdl::NodeLocation::make_from(lexeme.begin(), lexeme.end()), value);
+				auto value = state.ast().intern_handle(lexeme);
+				auto value_class = ast::classify_flat_value(std::string_view(lexeme.data(), lexeme.size()));
+				return state.ast().template create<ast::IdentifierValue>(ovdl::NodeLocation::make_from(lexeme.begin(), lexeme.end()), value, value_class);
 			});
 	};
 
@@ -89,8 +90,8 @@ namespace ovdl::v2script::grammar {
 			dsl::as_string_view<> >>
 			dsl::callback<ast::StringValue*>(
 				[](detail::IsParseState auto& state, std::string_view sv) {
-					auto value = state.ast().intern(sv);
-					return state.ast().template create<ast::StringValue>(ovdl::NodeLocation::make_from(sv.data(), sv.data() + sv.size()), value);
+					auto value = state.ast().intern_handle(sv);
+					return state.ast().template create<ast::StringValue>(ovdl::NodeLocation::make_from(sv.data(), sv.data() + sv.size()), value, ast::classify_flat_value(sv));
 				});
 	};
 
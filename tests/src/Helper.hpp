@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <type_traits>
+#include <utility>
 
 #include <openvic-dataloader/detail/Encoding.hpp>
 
@@ -75,4 +77,14 @@ namespace ovdl::testing {
 		testing::EncodingType<detail::Encoding::Windows1252>, //
 		testing::EncodingType<detail::Encoding::Windows1251>  //
 		>;
+
+	/// Runs function once, returns its result and the elapsed milliseconds for benchmark tests.
+	/// Benchmarks are tagged "[.benchmark]", hidden unless run with that tag filter.
+	template<typename Function>
+	auto measure(Function&& function) {
+		auto start = std::chrono::steady_clock::now();
+		auto result = function();
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return std::pair { result, elapsed };
+	}
 }
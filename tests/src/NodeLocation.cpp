@@ -1,8 +1,11 @@
+#include <cstdint>
 #include <span>
+#include <string>
 #include <string_view>
 
 #include <openvic-dataloader/NodeLocation.hpp>
 
+#include "Helper.hpp"
 #include <snitch/snitch.hpp>
 
 using namespace ovdl;
@@ -299,3 +302,57 @@ TEST_CASE("NodeLocation", "[node-location]") {
 	CHECK_FALSE(char_8_node_make.is_synthesized());
 #endif
 }
+
+TEST_CASE("CompactNodeLocation", "[node-location]") {
+	static constexpr auto buffer = "abcdef"sv;
+
+	CompactNodeLocation synthesized;
+	CHECK(synthesized.is_synthesized());
+	CHECK(synthesized.to_location(buffer.data()).is_synthesized());
+	CHECK(CompactNodeLocation::from(NodeLocation {}, buffer.data()).is_synthesized());
+
+	auto compact = CompactNodeLocation::from(NodeLocation(&buffer[1], &buffer[4]), buffer.data());
+	CHECK_FALSE(compact.is_synthesized());
+	CHECK(compact.begin_offset() == 1);
+	CHECK(compact.end_offset() == 4);
+	CHECK(sizeof(compact) == 2 * sizeof(std::uint32_t));
+
+	auto location = compact.to_location(buffer.data());
+	CHECK(location.begin() == &buffer[1]);
+	CHECK(location.end() == &buffer[4]);
+
+	// Offsets stay valid for a copy of the buffer.
+	std::string copy { buffer };
+	auto relocated = compact.to_location(copy.data());
+	CHECK(relocated.begin() == copy.data() + 1);
+	CHECK(relocated.end() == copy.data() + 4);
+}
+
+TEST_CASE("NodeLocationTable", "[node-location]") {
+	NodeLocationTable table;
+	LocationSlot first, second, unset;
+
+	CHECK(first.location_index() == LocationSlot::npos);
+	CHECK(table.find(first) == nullptr);
+
+	table.set(first, { 0, 2 });
+	table.set(second, { 3, 3 });
+	CHECK(first.location_index() == 0);
+	CHECK(second.location_index() == 1);
+	CHECK(table.size() == 2);
+	CHECK(table.find(unset) == nullptr);
+
+	auto* location = table.find(first);
+	CHECK_IF(location != nullptr) {
+		CHECK(*location == CompactNodeLocation(0, 2));
+	}
+
+	// Setting again overwrites in place.
+	table.set(first, { 4, 4 });
+	CHECK(first.location_index() == 0);
+	CHECK(table.size() == 2);
+	location = table.find(first);
+	CHECK_IF(location != nullptr) {
+		CHECK(*location == CompactNodeLocation(4, 4));
+	}
+}
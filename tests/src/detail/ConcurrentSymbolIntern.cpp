@@ -0,0 +1,77 @@
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
+
+#include "Helper.hpp"
+#include <snitch/snitch.hpp>
+
+using namespace std::string_view_literals;
+
+using concurrent_symbol_interner = ovdl::concurrent_symbol_interner<struct Id, char, std::uint32_t>;
+using symbol_handle = concurrent_symbol_interner::symbol_handle;
+
+TEST_CASE("concurrent_symbol_interner", "[concurrent-symbol-interner]") {
+	concurrent_symbol_interner interner;
+
+	CHECK_FALSE(interner.find_intern("test"));
+	CHECK(interner.size() == 0);
+
+	auto test = interner.intern_handle("test");
+	CHECK(test);
+	CHECK(interner.intern_handle("test") == test);
+	CHECK(interner.find_handle("test") == test);
+	CHECK(interner.resolve(test).view() == "test"sv);
+	CHECK(interner.intern("test") == interner.find_intern("test"));
+
+	auto tes = interner.intern_handle("tes");
+	CHECK(tes != test);
+	CHECK(interner.resolve(tes).view() == "tes"sv);
+	CHECK_FALSE(interner.find_handle("te"));
+	CHECK(interner.size() == 2);
+
+	CHECK_FALSE(interner.resolve(symbol_handle()));
+}
+
+TEST_CASE("concurrent_symbol_interner, threads", "[concurrent-symbol-interner][threads]") {
+	static constexpr std::size_t thread_count = 8;
+	static constexpr std::size_t symbol_count = 20000;
+
+	concurrent_symbol_interner interner;
+
+	std::vector<std::string> strings;
+	strings.reserve(symbol_count);
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		strings.push_back("symbol_" + std::to_string(i));
+	}
+
+	// Every thread interns every string, starting at a different offset to force contention.
+	std::vector<std::vector<symbol_handle>> results(thread_count, std::vector<symbol_handle>(symbol_count));
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < thread_count; ++t) {
+		threads.emplace_back([&, t] {
+			for (std::size_t n = 0; n < symbol_count; ++n) {
+				auto i = (n + t * (symbol_count / thread_count)) % symbol_count;
+				results[t][i] = interner.intern_handle(strings[i].data(), strings[i].size());
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	CHECK(interner.size() == symbol_count);
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		auto handle = results[0][i];
+		for (std::size_t t = 1; t < thread_count; ++t) {
+			mismatches += results[t][i] != handle;
+		}
+		mismatches += interner.resolve(handle).view() != strings[i];
+		mismatches += interner.find_handle(strings[i].data(), strings[i].size()) != handle;
+	}
+	CHECK(mismatches == 0);
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <detail/LineIndex.hpp>
+
+#include "Helper.hpp"
+#include <snitch/snitch.hpp>
+
+using namespace ovdl::detail;
+using namespace std::string_view_literals;
+
+// Scans from the start of the buffer like lexy::get_input_location does.
+static LineIndex::LineColumn reference_resolve(std::string_view buffer, std::uint32_t offset) {
+	LineIndex::LineColumn result { 1, 1 };
+	for (std::uint32_t i = 0; i < offset; ++i) {
+		if (buffer[i] == '\n') {
+			result.line++;
+			result.column = 1;
+		} else if ((static_cast<unsigned char>(buffer[i]) & 0xC0) != 0x80) {
+			result.column++;
+		}
+	}
+	return result;
+}
+
+TEST_CASE("LineIndex", "[line-index]") {
+	static constexpr auto buffer = "a = b\r\nc = {\n\t\xC5\x92 = \"d\"\n\n}"sv;
+	LineIndex index(buffer.data(), buffer.size());
+
+	CHECK(index.line_count() == 5);
+	CHECK(index.line_of(0) == 1);
+	CHECK(index.line_of(6) == 1);
+	CHECK(index.line_of(7) == 2);
+	CHECK(index.line_of(std::uint32_t(buffer.size())) == 5);
+
+	std::size_t mismatches = 0;
+	std::vector<std::uint32_t> offsets;
+	for (std::uint32_t offset = 0; offset <= buffer.size(); ++offset) {
+		auto expected = reference_resolve(buffer, offset);
+		auto actual = index.resolve(buffer.data(), offset);
+		mismatches += expected.line != actual.line || expected.column != actual.column;
+		offsets.push_back(offset);
+	}
+	CHECK(mismatches == 0);
+
+	// Column counts code points, the two byte character is one column.
+	auto after_multibyte = index.resolve(buffer.data(), 16);
+	CHECK(after_multibyte.line == 3);
+	CHECK(after_multibyte.column == 3);
+
+	std::vector<LineIndex::LineColumn> batch(offsets.size());
+	index.resolve_sorted(buffer.data(), offsets, batch);
+	mismatches = 0;
+	for (std::size_t i = 0; i < offsets.size(); ++i) {
+		auto expected = reference_resolve(buffer, offsets[i]);
+		mismatches += expected.line != batch[i].line || expected.column != batch[i].column;
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("LineIndex, empty buffer", "[line-index]") {
+	LineIndex index(nullptr, 0);
+	CHECK(index.line_count() == 1);
+
+	auto position = index.resolve(nullptr, 0);
+	CHECK(position.line == 1);
+	CHECK(position.column == 1);
+}
+
+TEST_CASE("LineIndex, detached", "[line-index]") {
+	// Long ASCII runs between multibyte characters cross the eight byte steps of detach.
+	std::string buffer = "name = \"\xC5\x92uvre\"\r\n";
+	for (int i = 0; i < 20; ++i) {
+		buffer += "key_" + std::to_string(i) + " = { \xE6\x97\xA5\xE6\x9C\xAC 1 2 3 }\n";
+	}
+	buffer += "\xF0\x9F\x98\x80";
+
+	LineIndex index(buffer.data(), buffer.size());
+	index.detach(buffer.data(), buffer.size());
+	CHECK(index.is_detached());
+
+	// Overwrites the buffer to make sure it is no longer read.
+	auto copy = buffer;
+	std::fill(buffer.begin(), buffer.end(), '\n');
+
+	std::size_t mismatches = 0;
+	for (std::uint32_t offset = 0; offset <= copy.size(); ++offset) {
+		auto expected = reference_resolve(copy, offset);
+		auto actual = index.resolve(offset);
+		mismatches += expected.line != actual.line || expected.column != actual.column;
+	}
+	CHECK(mismatches == 0);
+}
@@ -0,0 +1,247 @@
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <openvic-dataloader/detail/NumericText.hpp>
+
+#include "Helper.hpp"
+#include <snitch/snitch.hpp>
+
+using namespace ovdl::detail;
+using namespace std::string_view_literals;
+
+TEST_CASE("numeric text classification", "[numeric-text]") {
+	CHECK(is_integer_text("0"sv));
+	CHECK(is_integer_text("-3"sv));
+	CHECK(is_integer_text("+12"sv));
+	CHECK_FALSE(is_integer_text(""sv));
+	CHECK_FALSE(is_integer_text("-"sv));
+	CHECK_FALSE(is_integer_text("1.0"sv));
+	CHECK_FALSE(is_integer_text("1a"sv));
+
+	CHECK(is_decimal_text("0.25"sv));
+	CHECK(is_decimal_text("-.5"sv));
+	CHECK(is_decimal_text("1."sv));
+	CHECK_FALSE(is_decimal_text("."sv));
+	CHECK_FALSE(is_decimal_text("1"sv));
+	CHECK_FALSE(is_decimal_text("1836.1.1"sv));
+
+	CHECK(is_date_text("1836.1.1"sv));
+	CHECK(is_date_text("0.12.31"sv));
+	CHECK_FALSE(is_date_text("1836.1"sv));
+	CHECK_FALSE(is_date_text("1836..1"sv));
+	CHECK_FALSE(is_date_text("1836.1.1."sv));
+	CHECK_FALSE(is_date_text("-1836.1.1"sv));
+}
+
+TEST_CASE("numeric text parsing", "[numeric-text]") {
+	CHECK(parse_integer_text("-3"sv) == -3);
+	CHECK(parse_integer_text("+12"sv) == 12);
+	CHECK(parse_integer_text("9223372036854775807"sv) == INT64_MAX);
+	CHECK_FALSE(parse_integer_text("9223372036854775808"sv));
+	CHECK_FALSE(parse_integer_text("12a"sv));
+
+	CHECK(parse_decimal_text("0.25"sv) == 0.25);
+	CHECK(parse_decimal_text("-.5"sv) == -0.5);
+	CHECK(parse_decimal_text("+2"sv) == 2.0);
+	CHECK_FALSE(parse_decimal_text("0.2.5"sv));
+	CHECK_FALSE(parse_decimal_text("+-0.5"sv));
+
+	CHECK(parse_date_text("1836.1.1"sv) == date_parts { 1836, 1, 1 });
+	CHECK(parse_date_text("1936.12.31"sv) == date_parts { 1936, 12, 31 });
+	CHECK_FALSE(parse_date_text("1836.256.1"sv));
+	CHECK_FALSE(parse_date_text("1836.1"sv));
+}
+
+static std::optional<std::int64_t> from_chars_integer(std::string_view text) {
+	std::int64_t result;
+	auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), result);
+	if (error != std::errc {} || end != text.data() + text.size()) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+static std::vector<std::string> make_integers(std::size_t count, std::size_t max_digits) {
+	std::mt19937_64 random(7);
+	std::vector<std::string> result;
+	for (std::size_t i = 0; i < count; ++i) {
+		std::string text = random() % 4 == 0 ? "-" : "";
+		auto digit_count = 1 + random() % max_digits;
+		for (std::size_t digit = 0; digit < digit_count; ++digit) {
+			text += char('0' + random() % 10);
+		}
+		result.push_back(std::move(text));
+	}
+	return result;
+}
+
+TEST_CASE("integer text parsing, eight digits at a time", "[numeric-text]") {
+	CHECK(is_eight_digits("01234567"));
+	CHECK_FALSE(is_eight_digits("0123456:"));
+	CHECK_FALSE(is_eight_digits("/1234567"));
+	CHECK_FALSE(is_eight_digits("0123\xff" "567"));
+	CHECK_FALSE(is_eight_digits("0123\x80" "567"));
+
+	CHECK(parse_eight_digits("00000000") == 0);
+	CHECK(parse_eight_digits("12345678") == 12345678);
+	CHECK(parse_eight_digits("99999999") == 99999999);
+
+	CHECK(parse_integer_text("0"sv) == 0);
+	CHECK(parse_integer_text("-0"sv) == 0);
+	CHECK(parse_integer_text("007"sv) == 7);
+	CHECK(parse_integer_text("9999999999999999"sv) == 9999999999999999);
+	CHECK(parse_integer_text("-9223372036854775808"sv) == INT64_MIN);
+	CHECK_FALSE(parse_integer_text(""sv));
+	CHECK_FALSE(parse_integer_text("-"sv));
+	CHECK_FALSE(parse_integer_text("--5"sv));
+	CHECK_FALSE(parse_integer_text("-+5"sv));
+	CHECK_FALSE(parse_integer_text("+-5"sv));
+	CHECK_FALSE(parse_integer_text("+-123456789012"sv));
+	CHECK_FALSE(parse_integer_text("-+123456789012"sv));
+	CHECK(parse_integer_text("+123456789012"sv) == 123456789012);
+	CHECK_FALSE(parse_integer_text("1 2"sv));
+	CHECK_FALSE(parse_integer_text("12:4"sv));
+
+	std::size_t mismatches = 0;
+	for (const auto& text : make_integers(5000, 19)) {
+		mismatches += parse_integer_text(text) != from_chars_integer(text);
+	}
+	CHECK(mismatches == 0);
+}
+
+// Multiplies the whole decimal digit string by two fractional_bits times, then rounds at the decimal point.
+static std::optional<std::int64_t> reference_fixed_point(std::string_view text, unsigned fractional_bits) {
+	bool is_negative = text.front() == '-';
+	if (text.front() == '-' || text.front() == '+') {
+		text.remove_prefix(1);
+	}
+
+	auto dot = text.find('.');
+	std::string digits { text.substr(0, dot) };
+	if (dot != std::string_view::npos) {
+		digits += text.substr(dot + 1);
+	}
+	std::size_t point = dot == std::string_view::npos ? text.size() : dot;
+
+	for (unsigned bit = 0; bit < fractional_bits; ++bit) {
+		int carry = 0;
+		for (std::size_t i = digits.size(); i-- > 0;) {
+			int doubled = (digits[i] - '0') * 2 + carry;
+			digits[i] = char('0' + doubled % 10);
+			carry = doubled / 10;
+		}
+		if (carry != 0) {
+			digits.insert(digits.begin(), '1');
+			++point;
+		}
+	}
+
+	std::uint64_t magnitude = 0;
+	for (std::size_t i = 0; i < point; ++i) {
+		if (magnitude > (UINT64_MAX - 9) / 10) {
+			return std::nullopt;
+		}
+		magnitude = magnitude * 10 + std::uint64_t(digits[i] - '0');
+	}
+	if (point < digits.size() && digits[point] >= '5') {
+		++magnitude;
+	}
+	if (magnitude > std::uint64_t(INT64_MAX)) {
+		return std::nullopt;
+	}
+	return is_negative ? -std::int64_t(magnitude) : std::int64_t(magnitude);
+}
+
+static std::vector<std::string> make_decimals(std::size_t count, std::size_t max_fraction_digits) {
+	std::mt19937_64 random(42);
+	std::vector<std::string> result;
+	for (std::size_t i = 0; i < count; ++i) {
+		std::string text = random() % 4 == 0 ? "-" : "";
+		text += std::to_string(random() % 1000000);
+		auto fraction_digits = random() % (max_fraction_digits + 1);
+		if (fraction_digits != 0 || random() % 2 == 0) {
+			text += '.';
+		}
+		for (std::size_t digit = 0; digit < fraction_digits; ++digit) {
+			text += char('0' + random() % 10);
+		}
+		result.push_back(std::move(text));
+	}
+	return result;
+}
+
+TEST_CASE("fixed-point text parsing", "[numeric-text]") {
+	CHECK(parse_fixed_point_text("1"sv, 16) == 65536);
+	CHECK(parse_fixed_point_text("0.5"sv, 1) == 1);
+	CHECK(parse_fixed_point_text("-0.25"sv, 16) == -16384);
+	CHECK(parse_fixed_point_text("0.1"sv, 0) == 0);
+	// Ties round away from zero.
+	CHECK(parse_fixed_point_text("0.5"sv, 0) == 1);
+	CHECK(parse_fixed_point_text("-2.5"sv, 0) == -3);
+	CHECK(parse_fixed_point_text("0.1"sv, 32) == 429496730);
+	CHECK(parse_fixed_point_text("2147483647.9999999998"sv, 32) == INT64_MAX);
+	// Rounds up past the largest representable value.
+	CHECK_FALSE(parse_fixed_point_text("2147483647.99999999999"sv, 32));
+	CHECK_FALSE(parse_fixed_point_text("2147483648"sv, 32));
+	CHECK_FALSE(parse_fixed_point_text("1"sv, 63));
+	CHECK_FALSE(parse_fixed_point_text("word"sv, 16));
+	CHECK_FALSE(parse_fixed_point_text("1836.1.1"sv, 16));
+
+	static constexpr unsigned bit_counts[] { 0, 1, 8, 16, 24, 32, 40, 44 };
+	auto decimals = make_decimals(2000, 30);
+	decimals.push_back("0.00000000000000000000000000000000000000000000001");
+	decimals.push_back("999999.999999999999999999999999999999");
+	decimals.push_back("0.9999999999999999999");
+
+	std::size_t mismatches = 0;
+	for (auto bits : bit_counts) {
+		for (const auto& text : decimals) {
+			mismatches += parse_fixed_point_text(text, bits) != reference_fixed_point(text, bits);
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("fixed-point text parsing, benchmark", "[.benchmark][numeric-text]") {
+	using ovdl::testing::measure;
+
+	static constexpr unsigned fractional_bits = 16;
+	auto decimals = make_decimals(200000, 6);
+
+	auto [fixed_sum, fixed_ms] = measure([&] {
+		std::int64_t sum = 0;
+		for (const auto& text : decimals) {
+			sum += parse_fixed_point_text(text, fractional_bits).value_or(0);
+		}
+		return sum;
+	});
+	auto [reference_sum, reference_ms] = measure([&] {
+		std::int64_t sum = 0;
+		for (const auto& text : decimals) {
+			sum += reference_fixed_point(text, fractional_bits).value_or(0);
+		}
+		return sum;
+	});
+	auto [double_sum, double_ms] = measure([&] {
+		std::int64_t sum = 0;
+		for (const auto& text : decimals) {
+			sum += std::llround(parse_decimal_text(text).value_or(0) * double(1 << fractional_bits));
+		}
+		return sum;
+	});
+
+	CHECK(fixed_sum == reference_sum);
+
+	std::printf("fixed-point benchmark, %zu decimals, %u fractional bits\n", decimals.size(), fractional_bits);
+	std::printf("  parse_fixed_point_text: %8.3f ms\n", fixed_ms);
+	std::printf("  reference:              %8.3f ms\n", reference_ms);
+	std::printf("  through double:         %8.3f ms (sum differs by %lld)\n", double_ms, (long long)(double_sum - fixed_sum));
+}
@@ -1,5 +1,11 @@
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <istream>
+#include <sstream>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <openvic-dataloader/detail/SymbolIntern.hpp>
 #include <openvic-dataloader/detail/pinned_vector.hpp>
@@ -97,6 +103,13 @@ TEST_CASE("symbol_interner", "[symbol-intern]") {
 
 	CHECK(test == test2);
 
+	// Prefixes of existing symbols are distinct symbols.
+	auto tes = interner.intern("tes");
+	CHECK(tes.view() == "tes"sv);
+	CHECK_FALSE(tes == test);
+	CHECK(interner.find_intern("tes") == tes);
+	CHECK_FALSE(interner.find_intern("te"));
+
 	auto test3 = interner.intern("test3");
 
 	CHECK(test.view() == "test"sv);
@@ -136,3 +149,282 @@ TEST_CASE("symbol_interner", "[symbol-intern]") {
 		CHECK_FALSE(test5 == test4);
 	}
 }
+
+TEST_CASE("symbol_interner, handles", "[symbol-intern-handle]") {
+	symbol_interner interner(symbol_buffer::min_buffer_size * 2);
+
+	auto test = interner.intern_handle("test");
+	auto test2 = interner.intern_handle("test");
+	auto test3 = interner.intern_handle("test3");
+
+	CHECK(test);
+	CHECK(test3);
+	CHECK(test == test2);
+	CHECK_FALSE(test == test3);
+
+	// Handles are dense and assigned in insertion order.
+	CHECK(test.id() == 0);
+	CHECK(test3.id() == 1);
+	CHECK(interner.size() == 2);
+
+	CHECK(test.view(interner) == "test"sv);
+	CHECK(test3.view(interner) == "test3"sv);
+	CHECK(interner.resolve(test) == interner.intern("test"));
+
+	// Lengths are stored by the interner, not recomputed from the null-terminator.
+	CHECK(interner.resolve(test).size() == 4);
+	CHECK(interner.resolve(test3).size() == 5);
+	CHECK(interner.resolve(test3).view().size() == 5);
+
+	CHECK(interner.find_handle("test3") == test3);
+	CHECK_FALSE(interner.find_handle("test4"));
+	CHECK_FALSE(interner.resolve(interner.find_handle("test4")));
+
+	CHECK_IF(interner.reserve(1024, 16 + 1)) {
+		CHECK(interner.find_handle("test") == test);
+		CHECK(interner.find_handle("test3") == test3);
+		CHECK(test3.view(interner) == "test3"sv);
+	}
+}
+
+TEST_CASE("symbol_interner, freeze", "[symbol-intern-freeze]") {
+	static constexpr std::size_t symbol_count = 5000;
+
+	symbol_interner interner(1 << 20);
+	CHECK_FALSE(interner.is_frozen());
+
+	std::vector<std::string> strings;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		strings.push_back("symbol_" + std::to_string(i));
+		interner.intern_handle(strings.back().data(), strings.back().size());
+	}
+
+	CHECK(interner.freeze());
+	CHECK(interner.is_frozen());
+	CHECK(interner.size() == symbol_count);
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		auto handle = interner.find_handle(strings[i].data(), strings[i].size());
+		mismatches += handle.id() != i;
+		mismatches += handle.view(interner) != strings[i];
+	}
+	CHECK(mismatches == 0);
+
+	CHECK_FALSE(interner.find_handle("symbol_"));
+	CHECK_FALSE(interner.find_intern("unknown"));
+
+	// Frozen interners only return symbols interned before freezing.
+	CHECK(interner.intern_handle("symbol_0").id() == 0);
+	CHECK_FALSE(interner.intern_handle("unknown"));
+	CHECK(interner.size() == symbol_count);
+
+	symbol_interner empty;
+	CHECK(empty.freeze());
+	CHECK_FALSE(empty.find_handle("test"));
+}
+
+TEST_CASE("symbol_interner, snapshot", "[symbol-intern-snapshot]") {
+	symbol_interner interner(symbol_buffer::min_buffer_size * 2);
+
+	auto test = interner.intern_handle("test");
+	auto tes = interner.intern_handle("tes");
+	auto empty = interner.intern_handle("");
+
+	std::stringstream stream;
+	CHECK_OR_RETURN(interner.write_snapshot(stream));
+
+	symbol_interner restored(symbol_buffer::min_buffer_size * 2);
+	CHECK_OR_RETURN(restored.read_snapshot(stream));
+
+	CHECK(restored.size() == 3);
+	CHECK(restored.find_handle("test") == test);
+	CHECK(restored.find_handle("tes") == tes);
+	CHECK(restored.find_handle("") == empty);
+	CHECK(test.view(restored) == "test"sv);
+	CHECK_FALSE(restored.find_handle("te"));
+
+	// Interning continues after the restored symbols.
+	CHECK(restored.intern_handle("test") == test);
+	CHECK(restored.intern_handle("test3").id() == 3);
+
+	std::string corrupt = stream.str();
+	corrupt[0] = 'X';
+	std::stringstream corrupt_stream(corrupt);
+	symbol_interner rejected;
+	CHECK_FALSE(rejected.read_snapshot(corrupt_stream));
+	CHECK(rejected.size() == 0);
+	CHECK_FALSE(rejected.find_handle("test"));
+
+	// A header claiming far more than the stream holds fails at its end instead of allocating the claim.
+	std::string truncated = stream.str();
+	std::uint64_t symbol_count = 0xFFFF0000, buffer_size = 0xFFFFFFFF;
+	std::memcpy(truncated.data() + 16, &symbol_count, sizeof(symbol_count));
+	std::memcpy(truncated.data() + 24, &buffer_size, sizeof(buffer_size));
+	std::stringstream truncated_stream(truncated);
+	symbol_interner chunked(0, ovdl::symbol_storage::chunked);
+	CHECK_FALSE(chunked.read_snapshot(truncated_stream));
+	CHECK(chunked.size() == 0);
+
+	// Without a length to check, reading stops at the end of the stream.
+	struct unseekable_buffer : std::streambuf {
+		explicit unseekable_buffer(std::string& data) {
+			setg(data.data(), data.data(), data.data() + data.size());
+		}
+	} unseekable { truncated };
+	std::istream unseekable_stream(&unseekable);
+	CHECK_FALSE(chunked.read_snapshot(unseekable_stream));
+	CHECK(chunked.size() == 0);
+}
+
+TEST_CASE("symbol_interner, case-insensitive", "[symbol-intern-ci]") {
+	symbol_interner interner(symbol_buffer::min_buffer_size * 2);
+
+	auto eng = interner.intern_handle("ENG");
+	interner.enable_case_insensitive_index();
+	CHECK(interner.has_case_insensitive_index());
+
+	auto eng_lower = interner.intern_handle("eng");
+	auto modifier = interner.intern_handle("Local_Modifier");
+	CHECK(eng != eng_lower);
+
+	CHECK(interner.find_handle_ci("eng") == eng);
+	CHECK(interner.find_handle_ci("Eng") == eng);
+	CHECK(interner.find_intern_ci("eNG").view() == "ENG"sv);
+	CHECK(interner.find_handle_ci("local_modifier") == modifier);
+	CHECK_FALSE(interner.find_handle_ci("en"));
+	CHECK_FALSE(interner.find_handle_ci("eng_"));
+
+	CHECK(interner.canonical_handle(eng_lower) == eng);
+	CHECK(interner.canonical_handle(modifier) == modifier);
+	CHECK_FALSE(interner.canonical_handle(symbol_interner::symbol_handle()));
+}
+
+#ifdef OPENVIC_DATALOADER_INTERN_STATISTICS
+TEST_CASE("symbol_interner, statistics", "[symbol-intern-statistics]") {
+	symbol_interner interner(symbol_buffer::min_buffer_size * 2);
+
+	auto empty = interner.compute_statistics();
+	CHECK(empty.symbol_count == 0);
+	CHECK(empty.buffer_bytes == 0);
+	CHECK(empty.table.size == 0);
+	CHECK(empty.table.load_factor == 0);
+
+	for (std::size_t i = 0; i < 1000; ++i) {
+		auto string = std::to_string(i);
+		interner.intern_handle(string.data(), string.size());
+	}
+
+	auto statistics = interner.compute_statistics();
+	CHECK(statistics.symbol_count == 1000);
+	CHECK(statistics.buffer_bytes == 10 * 2 + 90 * 3 + 900 * 4);
+	CHECK(statistics.buffer_bytes <= statistics.buffer_capacity_bytes);
+	CHECK(statistics.buffer_capacity_bytes <= statistics.buffer_max_bytes);
+	CHECK(statistics.table.size == 1000);
+	CHECK(statistics.table.capacity >= 2000);
+	CHECK(statistics.table.load_factor <= 0.5);
+	CHECK(statistics.table.rehash_count >= 1);
+	CHECK(statistics.table.average_probe_length >= 1.0);
+	CHECK(statistics.table.max_probe_length >= 1);
+	CHECK(statistics.case_insensitive_table.capacity == 0);
+}
+#endif
+
+TEST_CASE("symbol_interner, chunked storage", "[symbol-intern-chunked]") {
+	symbol_interner interner(1 << 20, ovdl::symbol_storage::chunked);
+
+	auto test = interner.intern("test");
+	CHECK(interner.intern("test") == test);
+	CHECK(test.view() == "test"sv);
+
+	// Enough symbols to span several chunks, plus one larger than a chunk.
+	std::vector<std::string> strings;
+	std::vector<symbol> symbols;
+	for (std::size_t i = 0; i < 5000; ++i) {
+		strings.push_back("symbol_" + std::to_string(i));
+		symbols.push_back(interner.intern(strings.back().data(), strings.back().size()));
+	}
+	std::string large(symbol_buffer::chunk_size * 2, 'x');
+	auto large_symbol = interner.intern(large.data(), large.size());
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < strings.size(); ++i) {
+		mismatches += symbols[i].view() != strings[i];
+		mismatches += interner.find_intern(strings[i].data(), strings[i].size()) != symbols[i];
+	}
+	CHECK(mismatches == 0);
+	CHECK(large_symbol.view() == large);
+	CHECK(interner.find_intern(large.data(), large.size()) == large_symbol);
+	CHECK(test.view() == "test"sv);
+
+	std::stringstream stream;
+	CHECK_OR_RETURN(interner.write_snapshot(stream));
+	for (auto storage : { ovdl::symbol_storage::reserved, ovdl::symbol_storage::chunked }) {
+		stream.seekg(0);
+		symbol_interner restored(1 << 20, storage);
+		CHECK_OR_RETURN(restored.read_snapshot(stream));
+		CHECK(restored.size() == interner.size());
+		CHECK(restored.find_intern(large.data(), large.size()).view() == large);
+		CHECK(restored.find_intern("symbol_4999").view() == "symbol_4999"sv);
+	}
+}
+
+TEST_CASE("symbol_interner, chunked storage ignores the size hint", "[symbol-intern-chunked]") {
+	symbol_interner tiny(100, ovdl::symbol_storage::chunked);
+	auto a = tiny.intern_handle("a");
+	CHECK(bool(a));
+	CHECK(tiny.resolve(a).view() == "a"sv);
+
+	symbol_interner small(20000, ovdl::symbol_storage::chunked);
+	std::size_t failures = 0;
+	for (std::size_t i = 0; i < 5000; ++i) {
+		auto string = "symbol_" + std::to_string(i);
+		failures += !small.intern_handle(string.data(), string.size());
+	}
+	CHECK(failures == 0);
+	CHECK(small.size() == 5000);
+
+	ovdl::symbol_storage_scope scope { ovdl::symbol_storage::chunked };
+	symbol_interner defaulted;
+	CHECK(defaulted.intern("error: message").view() == "error: message"sv);
+}
+
+TEST_CASE("symbol_storage, default", "[symbol-intern-chunked]") {
+	CHECK(ovdl::default_symbol_storage() == ovdl::symbol_storage::reserved);
+	{
+		ovdl::symbol_storage_scope scope { ovdl::symbol_storage::chunked };
+		CHECK(ovdl::default_symbol_storage() == ovdl::symbol_storage::chunked);
+		CHECK(symbol_buffer().storage() == ovdl::symbol_storage::chunked);
+	}
+	CHECK(ovdl::default_symbol_storage() == ovdl::symbol_storage::reserved);
+	CHECK(symbol_buffer().storage() == ovdl::symbol_storage::reserved);
+}
+
+TEST_CASE("symbol_interner, intern_many", "[symbol-intern-many]") {
+	symbol_interner interner(1 << 20);
+
+	auto existing = interner.intern_handle("symbol_3");
+
+	std::vector<std::string> strings;
+	for (std::size_t i = 0; i < 100; ++i) {
+		strings.push_back("symbol_" + std::to_string(i % 40));
+	}
+	std::vector<std::string_view> views(strings.begin(), strings.end());
+	std::vector<symbol_interner::symbol_handle> handles(views.size());
+
+	CHECK(interner.intern_many(views, handles));
+	CHECK(interner.size() == 40);
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < views.size(); ++i) {
+		mismatches += handles[i] != interner.find_handle(views[i].data(), views[i].size());
+		mismatches += handles[i].view(interner) != views[i];
+		mismatches += handles[i] != handles[i % 40];
+	}
+	CHECK(mismatches == 0);
+	CHECK(handles[3] == existing);
+
+	std::vector<symbol> symbols(views.size());
+	CHECK(interner.intern_many(views, symbols));
+	CHECK(symbols[41] == interner.resolve(handles[1]));
+}
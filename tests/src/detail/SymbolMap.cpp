@@ -0,0 +1,161 @@
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <openvic-dataloader/detail/SymbolIntern.hpp>
+#include <openvic-dataloader/detail/SymbolMap.hpp>
+
+#include "Helper.hpp"
+#include <snitch/snitch.hpp>
+
+using namespace std::string_view_literals;
+
+using symbol_interner = ovdl::SymbolIntern::symbol_interner_type;
+
+TEST_CASE("symbol_map", "[symbol-map]") {
+	symbol_interner interner(1 << 16);
+	ovdl::symbol_map<int> map;
+
+	auto a = interner.intern_handle("a");
+	auto b = interner.intern_handle("b");
+	auto c = interner.intern_handle("c");
+
+	CHECK(map.empty());
+	CHECK_FALSE(map.find(a));
+	CHECK_FALSE(map.contains(ovdl::SymbolIntern::symbol_handle_type()));
+
+	CHECK(map.insert(a, 1).second);
+	CHECK_FALSE(map.insert(a, 2).second);
+	map[b] = 3;
+
+	CHECK(map.size() == 2);
+	CHECK_IF(map.find(a)) {
+		CHECK(*map.find(a) == 1);
+	}
+	CHECK(map[b] == 3);
+	CHECK_FALSE(map.contains(c));
+
+	int sum = 0;
+	for (const auto& entry : map) {
+		sum += entry.value;
+	}
+	CHECK(sum == 4);
+
+	CHECK(map.erase(a));
+	CHECK_FALSE(map.erase(a));
+	CHECK_FALSE(map.contains(a));
+	CHECK(map.contains(b));
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("symbol_map, growth and erase", "[symbol-map]") {
+	static constexpr std::size_t symbol_count = 5000;
+
+	symbol_interner interner(1 << 20);
+	ovdl::symbol_map<std::size_t> map;
+
+	std::vector<ovdl::SymbolIntern::symbol_handle_type> handles;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		auto string = std::to_string(i);
+		handles.push_back(interner.intern_handle(string.data(), string.size()));
+		map[handles.back()] = i;
+	}
+	CHECK(map.size() == symbol_count);
+	CHECK(map.capacity() >= symbol_count * 2);
+
+	// Erase every odd symbol, probe sequences of the remaining ones must survive.
+	for (std::size_t i = 1; i < symbol_count; i += 2) {
+		map.erase(handles[i]);
+	}
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		auto* value = map.find(handles[i]);
+		mismatches += (i % 2 == 0) ? (value == nullptr || *value != i) : (value != nullptr);
+	}
+	CHECK(mismatches == 0);
+	CHECK(map.size() == symbol_count / 2);
+}
+
+TEST_CASE("symbol_set", "[symbol-set]") {
+	symbol_interner interner(1 << 16);
+	ovdl::symbol_set<> set;
+
+	auto a = interner.intern_handle("a");
+	auto b = interner.intern_handle("b");
+
+	CHECK(set.insert(a));
+	CHECK_FALSE(set.insert(a));
+	CHECK(set.contains(a));
+	CHECK_FALSE(set.contains(b));
+	CHECK(set.size() == 1);
+
+	std::size_t visited = 0;
+	set.for_each([&](auto handle) {
+		visited += handle == a;
+	});
+	CHECK(visited == 1);
+
+	CHECK(set.erase(a));
+	CHECK(set.empty());
+}
+
+TEST_CASE("symbol_map, benchmark", "[.benchmark][symbol-map]") {
+	using ovdl::testing::measure;
+
+	static constexpr std::size_t symbol_count = 100000;
+	static constexpr std::size_t lookup_rounds = 20;
+
+	symbol_interner interner(1 << 24);
+
+	std::vector<std::string> strings;
+	std::vector<ovdl::SymbolIntern::symbol_handle_type> handles;
+	for (std::size_t i = 0; i < symbol_count; ++i) {
+		strings.push_back("key_" + std::to_string(i));
+		handles.push_back(interner.intern_handle(strings.back().data(), strings.back().size()));
+	}
+
+	std::unordered_map<std::string_view, std::size_t> string_map;
+	ovdl::symbol_map<std::size_t> map;
+
+	auto [string_inserted, string_insert_ms] = measure([&] {
+		for (std::size_t i = 0; i < symbol_count; ++i) {
+			string_map.emplace(handles[i].view(interner), i);
+		}
+		return string_map.size();
+	});
+	auto [symbol_inserted, symbol_insert_ms] = measure([&] {
+		for (std::size_t i = 0; i < symbol_count; ++i) {
+			map.insert(handles[i], i);
+		}
+		return map.size();
+	});
+
+	auto [string_sum, string_lookup_ms] = measure([&] {
+		std::size_t sum = 0;
+		for (std::size_t round = 0; round < lookup_rounds; ++round) {
+			for (const auto& handle : handles) {
+				sum += string_map.find(handle.view(interner))->second;
+			}
+		}
+		return sum;
+	});
+	auto [symbol_sum, symbol_lookup_ms] = measure([&] {
+		std::size_t sum = 0;
+		for (std::size_t round = 0; round < lookup_rounds; ++round) {
+			for (const auto& handle : handles) {
+				sum += *map.find(handle);
+			}
+		}
+		return sum;
+	});
+
+	CHECK(string_inserted == symbol_inserted);
+	CHECK(string_sum == symbol_sum);
+
+	std::printf("symbol_map benchmark, %zu keys, %zu lookup rounds\n", symbol_count, lookup_rounds);
+	std::printf("  std::unordered_map<std::string_view>: insert %8.3f ms, lookup %8.3f ms\n", string_insert_ms, string_lookup_ms);
+	std::printf("  ovdl::symbol_map:                     insert %8.3f ms, lookup %8.3f ms\n", symbol_insert_ms, symbol_lookup_ms);
+}
@@ -0,0 +1,50 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <openvic-dataloader/detail/WorkStealing.hpp>
+
+#include "Helper.hpp"
+#include <snitch/snitch.hpp>
+
+namespace {
+	struct context {
+		std::vector<std::atomic<std::uint32_t>> runs;
+		std::atomic<std::uint64_t> sum = 0;
+
+		explicit context(std::size_t task_count) : runs(task_count) {}
+	};
+}
+
+static void run_task(void* ptr, std::size_t task) {
+	auto& state = *static_cast<context*>(ptr);
+	state.runs[task].fetch_add(1, std::memory_order_relaxed);
+
+	// Uneven task costs, later tasks are far more expensive and have to be stolen to balance.
+	std::uint64_t value = task;
+	for (std::size_t i = 0; i < task * 8; ++i) {
+		value = value * 6364136223846793005ull + 1442695040888963407ull;
+	}
+	state.sum.fetch_add(value % 2 + 1, std::memory_order_relaxed);
+}
+
+TEST_CASE("run_work_stealing", "[work-stealing][threads]") {
+	static constexpr std::size_t task_count = 5000;
+
+	for (std::size_t thread_count : { 0, 1, 3, 8 }) {
+		context state(task_count);
+		ovdl::detail::run_work_stealing(task_count, thread_count, &run_task, &state);
+
+		std::size_t wrong_runs = 0;
+		for (const auto& runs : state.runs) {
+			wrong_runs += runs.load() != 1;
+		}
+		CHECK(wrong_runs == 0);
+		CHECK(state.sum.load() >= task_count);
+	}
+
+	context empty(0);
+	ovdl::detail::run_work_stealing(0, 4, &run_task, &empty);
+	CHECK(empty.sum.load() == 0);
+}
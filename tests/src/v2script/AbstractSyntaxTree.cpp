@@ -30,7 +30,7 @@ struct Ast : SymbolIntern {
 
 	template<typename T, typename... Args>
 	T* create_with_intern(std::string_view view, Args&&... args) {
-		auto intern = symbol_interner.intern(view.data(), view.size());
+		auto intern = symbol_interner.intern_handle(view.data(), view.size());
 		auto node = tree.template create<T>(intern, DRYAD_FWD(args)...);
 		return node;
 	}
@@ -44,7 +44,7 @@ struct Ast : SymbolIntern {
 
 	template<typename T, typename... Args>
 	T* create_with_loc_and_intern(NodeLocation loc, std::string_view view, Args&&... args) {
-		auto intern = symbol_interner.intern(view.data(), view.size());
+		auto intern = symbol_interner.intern_handle(view.data(), view.size());
 		auto node = tree.template create<T>(intern, DRYAD_FWD(args)...);
 		set_location(node, loc);
 		return node;
@@ -69,13 +69,15 @@ TEST_CASE("V2Script Nodes", "[v2script-nodes]") {
 	auto* id = ast.create_with_intern<IdentifierValue>("id");
 	CHECK_IF(id) {
 		CHECK(id->kind() == NodeKind::IdentifierValue);
-		CHECK(id->value().view() == "id"sv);
+		CHECK(id->value(ast.symbol_interner).view() == "id"sv);
+		CHECK(id->handle() == ast.symbol_interner.find_handle("id"));
 	}
 
 	auto* str = ast.create_with_intern<StringValue>("str");
 	CHECK_IF(str) {
 		CHECK(str->kind() == NodeKind::StringValue);
-		CHECK(str->value().view() == "str"sv);
+		CHECK(str->value(ast.symbol_interner).view() == "str"sv);
+		CHECK(str->handle() != id->handle());
 	}
 
 	auto* list = ast.create<ListValue>();
@@ -118,6 +120,7 @@ TEST_CASE("V2Script Nodes", "[v2script-nodes]") {
 	statement_list.push_back(event);
 	CHECK_FALSE(statement_list.empty());
 	CHECK(ranges::distance(statement_list) == 3);
+	CHECK(statement_list.count() == 3);
 
 	for (const auto [statement_list_index, statement] : statement_list | ranges::views::enumerate) {
 		CAPTURE(statement_list_index);
@@ -133,6 +136,7 @@ TEST_CASE("V2Script Nodes", "[v2script-nodes]") {
 	auto* file_tree = ast.create<FileTree>(statement_list);
 	CHECK_IF(file_tree) {
 		CHECK(file_tree->kind() == NodeKind::FileTree);
+		CHECK(file_tree->statement_count() == 3);
 
 		const auto statements = file_tree->statements();
 		CHECK_FALSE(statements.empty());
@@ -162,7 +166,7 @@ TEST_CASE("V2Script Nodes Location", "[v2script-nodes-location]") {
 	auto* id = ast.create_with_loc_and_intern<IdentifierValue>(NodeLocation::make_from(&fake_buffer[0], &fake_buffer[1]), "id");
 
 	CHECK_IF(id) {
-		CHECK(id->value().view() == "id"sv);
+		CHECK(id->value(ast.symbol_interner).view() == "id"sv);
 
 		auto location = ast.location_of(id);
 		CHECK_FALSE(location.is_synthesized());
@@ -0,0 +1,74 @@
+#include <string_view>
+#include <vector>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/FlatTree.hpp>
+#include <openvic-dataloader/v2script/Parser.hpp>
+
+#include "Helper.hpp"
+#include <detail/NullBuff.hpp>
+#include <snitch/snitch.hpp>
+
+using namespace ovdl;
+using namespace v2script;
+using namespace std::string_view_literals;
+
+TEST_CASE("V2Script Flat Tree", "[v2script-flat-tree]") {
+	Parser parser(ovdl::detail::cnull);
+	parser.load_from_string("a = { b = c d } e = {}"sv);
+	CHECK_OR_RETURN(parser.simple_parse());
+
+	auto flat = parser.make_flat_tree();
+
+	using enum ast::NodeKind;
+	static constexpr ast::NodeKind expected_kinds[] {
+		FileTree,
+		AssignStatement, IdentifierValue, ListValue,
+		AssignStatement, IdentifierValue, IdentifierValue,
+		ValueStatement, IdentifierValue,
+		AssignStatement, IdentifierValue, ListValue
+	};
+	CHECK_OR_RETURN(flat.size() == std::size(expected_kinds));
+	for (ast::FlatTree::index_type index = 0; index < flat.size(); ++index) {
+		CAPTURE(index);
+		CHECK(flat[index].kind == expected_kinds[index]);
+	}
+
+	CHECK(flat[0].subtree_size == flat.size());
+	CHECK(flat[1].subtree_size == 8);
+	CHECK(flat.next_sibling(1) == 9);
+	CHECK(flat[11].subtree_size == 1);
+
+	std::vector<ast::FlatTree::index_type> top_level;
+	for (auto index : flat.children(0)) {
+		top_level.push_back(index);
+	}
+	CHECK(top_level == std::vector<ast::FlatTree::index_type> { 1, 9 });
+
+	std::vector<std::string_view> identifiers;
+	for (const auto& node : flat) {
+		if (node.is_flat_value()) {
+			identifiers.push_back(node.value(parser.symbol_resolver()).view());
+		}
+	}
+	CHECK(identifiers == std::vector { "a"sv, "b"sv, "c"sv, "d"sv, "e"sv });
+
+	CHECK(flat.source(0) == parser.get_file_node());
+	CHECK(flat.children(11).empty());
+}
+
+TEST_CASE("V2Script Flat Tree Builder", "[v2script-flat-tree]") {
+	ast::FlatTree::Builder builder;
+	builder.open(ast::NodeKind::FileTree);
+	builder.open(ast::NodeKind::ValueStatement);
+	builder.leaf(ast::NodeKind::NullValue);
+	builder.close();
+	builder.close();
+
+	auto flat = std::move(builder).finish();
+	CHECK(flat.size() == 3);
+	CHECK(flat[0].subtree_size == 3);
+	CHECK(flat[1].subtree_size == 2);
+	CHECK(flat.source(2) == nullptr);
+	CHECK(ast::FlatTree(nullptr).empty());
+}
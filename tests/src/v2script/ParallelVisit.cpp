@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/ParallelVisit.hpp>
+#include <openvic-dataloader/v2script/Parser.hpp>
+
+#include <dryad/node.hpp>
+
+#include "Helper.hpp"
+#include <detail/NullBuff.hpp>
+#include <snitch/snitch.hpp>
+
+using namespace ovdl;
+using namespace v2script;
+using namespace std::string_view_literals;
+
+TEST_CASE("V2Script Parallel Visit", "[v2script-parallel-visit][threads]") {
+	static constexpr std::size_t statement_count = 2000;
+
+	std::string buffer;
+	for (std::size_t i = 0; i < statement_count; ++i) {
+		buffer += "key_" + std::to_string(i) + " = { a = 1 b = { c = " + std::to_string(i) + " } }\n";
+	}
+
+	Parser parser(ovdl::detail::cnull);
+	parser.load_from_string(buffer);
+	CHECK_OR_RETURN(parser.simple_parse());
+
+	auto statements = parser.statement_array(parser.get_file_node());
+	CHECK_OR_RETURN(statements.size() == statement_count);
+
+	// Every statement is 12 nodes: the assignment, its key, the list and the nine nodes inside it.
+	auto chunks = ast::partition_statements(statements, 120);
+	CHECK(chunks.size() == statement_count / 10);
+	std::size_t covered = 0;
+	for (const auto& chunk : chunks) {
+		covered += chunk.size();
+	}
+	CHECK(covered == statement_count);
+	CHECK(ast::partition_statements(statements, 0).size() == statement_count);
+	CHECK(ast::partition_statements({}, 80).empty());
+
+	auto count_nodes = [](ast::StatementChunk chunk) {
+		std::size_t count = 0;
+		for (const auto* statement : chunk) {
+			for (auto [event, node] : dryad::traverse(statement)) {
+				count += event != dryad::traverse_event::exit;
+			}
+		}
+		return count;
+	};
+	auto sum = [](std::size_t& total, std::size_t count) {
+		total += count;
+	};
+	CHECK(ast::parallel_visit(statements, count_nodes, sum, { .thread_count = 4, .nodes_per_chunk = 64 }) == statement_count * 12);
+
+	// Options that are not a const lvalue still select the overload without a merge, the default 4096 nodes per
+	// chunk take 342 statements each.
+	CHECK(ast::parallel_visit(statements, count_nodes, ast::ParallelVisitOptions { .thread_count = 4 }).size() == 6);
+	ast::ParallelVisitOptions options { .thread_count = 4, .nodes_per_chunk = 120 };
+	auto counts = ast::parallel_visit(statements, count_nodes, options);
+	CHECK(counts.size() == chunks.size());
+	CHECK(counts.front() == 120);
+
+	// Results are merged in source order regardless of scheduling.
+	auto collect_keys = [&](ast::StatementChunk chunk) {
+		std::vector<std::string_view> keys;
+		for (const auto* statement : chunk) {
+			auto* assign = dryad::node_try_cast<ast::AssignStatement>(statement);
+			auto* key = assign ? dryad::node_try_cast<ast::FlatValue>(assign->left()) : nullptr;
+			keys.push_back(key ? parser.value(key) : ""sv);
+		}
+		return keys;
+	};
+	auto append = [](std::vector<std::string_view>& keys, std::vector<std::string_view> more) {
+		keys.insert(keys.end(), more.begin(), more.end());
+	};
+	auto keys = ast::parallel_visit(statements, collect_keys, append, { .thread_count = 8, .nodes_per_chunk = 16 });
+	CHECK_OR_RETURN(keys.size() == statement_count);
+
+	std::size_t out_of_order = 0;
+	for (std::size_t i = 0; i < statement_count; ++i) {
+		out_of_order += keys[i] != "key_" + std::to_string(i);
+	}
+	CHECK(out_of_order == 0);
+}
@@ -1,10 +1,20 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <string_view>
+#include <thread>
+#include <vector>
 
+#include <openvic-dataloader/detail/ConcurrentSymbolIntern.hpp>
 #include <openvic-dataloader/detail/Encoding.hpp>
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
+#include <openvic-dataloader/v2script/Forest.hpp>
+#include <openvic-dataloader/v2script/OverlayView.hpp>
 #include <openvic-dataloader/v2script/Parser.hpp>
+#include <openvic-dataloader/v2script/ValueExtraction.hpp>
 
 #include <dryad/node.hpp>
 
@@ -171,12 +181,16 @@ TEMPLATE_LIST_TEST_CASE("V2Script Identifier Simple Parse", "[v2script-id-simple
 		const auto* left = dryad::node_try_cast<ast::IdentifierValue>(assign->left());
 		CHECK_IF(left) {
 			CHECK(parser.value(left) == "a"sv);
+			CHECK(left->handle() == parser.find_handle("a"sv));
 		}
 
 		const auto* right = dryad::node_try_cast<ast::IdentifierValue>(assign->right());
 		CHECK_IF(right) {
 			CHECK(parser.value(right) == "b"sv);
+			CHECK(right->handle() == parser.find_handle("b"sv));
 		}
+
+		CHECK_FALSE(parser.find_handle("c"sv));
 	}
 
 	SECTION("a b c d") {
@@ -660,3 +674,611 @@ TEST_CASE("V2Script String Simple Windows-1251 Parse", "[v2script-id-simple-1251
 		}
 	}
 }
+
+TEMPLATE_LIST_TEST_CASE("V2Script Shared Symbol Interner Parse", "[v2script-shared-interner-parse]", testing::EncodingFallbackTypes) {
+	SymbolIntern::symbol_interner_type symbol_interner(1 << 16);
+
+	Parser first(symbol_interner, ovdl::detail::cnull);
+	Parser second(symbol_interner, ovdl::detail::cnull);
+
+	first.load_from_string("a = b"sv, TestType {});
+	second.load_from_string("a = c"sv, TestType {});
+
+	CHECK_OR_RETURN(first.simple_parse());
+	CHECK_OR_RETURN(second.simple_parse());
+	CHECK_FALSE(first.has_error() || second.has_error());
+
+	CHECK(symbol_interner.size() == 3);
+	CHECK(first.find_handle("a"sv) == second.find_handle("a"sv));
+	CHECK(first.find_handle("c"sv) == second.find_handle("c"sv));
+	CHECK(&first.symbol_interner() == &symbol_interner);
+
+	const auto* first_assign = dryad::node_try_cast<ast::AssignStatement>(first.get_file_node()->statements().front());
+	const auto* second_assign = dryad::node_try_cast<ast::AssignStatement>(second.get_file_node()->statements().front());
+	CHECK_OR_RETURN(first_assign && second_assign);
+
+	const auto* first_left = dryad::node_try_cast<ast::IdentifierValue>(first_assign->left());
+	const auto* second_left = dryad::node_try_cast<ast::IdentifierValue>(second_assign->left());
+	CHECK_IF(first_left && second_left) {
+		CHECK(first_left->handle() == second_left->handle());
+		CHECK(first_left->value(symbol_interner) == second_left->value(symbol_interner));
+		CHECK(first.value(first_left) == "a"sv);
+		CHECK(second.value(second_left) == "a"sv);
+	}
+
+	const auto* second_right = dryad::node_try_cast<ast::IdentifierValue>(second_assign->right());
+	CHECK_IF(second_right) {
+		CHECK(second.value(second_right) == "c"sv);
+		CHECK(second_right->handle() != first.find_handle("b"sv));
+	}
+}
+
+TEST_CASE("V2Script Concurrent Symbol Interner Parse", "[v2script-shared-interner-parse][threads]") {
+	ConcurrentSymbolIntern::symbol_interner_type symbol_interner;
+
+	Parser first(symbol_interner);
+	Parser second(symbol_interner);
+
+	first.load_from_string("a = { b = c }"sv);
+	second.load_from_string("a = { b = d }"sv);
+
+	bool first_result = false, second_result = false;
+	std::thread first_thread([&] { first_result = first.simple_parse(); });
+	std::thread second_thread([&] { second_result = second.simple_parse(); });
+	first_thread.join();
+	second_thread.join();
+
+	CHECK_OR_RETURN(first_result && second_result);
+	CHECK(symbol_interner.size() == 4);
+	CHECK(first.find_handle("a"sv) == second.find_handle("a"sv));
+	CHECK(first.find_handle("d"sv) == symbol_interner.find_handle("d"));
+
+	const auto* first_assign = dryad::node_try_cast<ast::AssignStatement>(first.get_file_node()->statements().front());
+	CHECK_OR_RETURN(first_assign);
+	const auto* first_left = dryad::node_try_cast<ast::IdentifierValue>(first_assign->left());
+	CHECK_IF(first_left) {
+		CHECK(first.value(first_left) == "a"sv);
+		CHECK(first_left->value(symbol_interner).view() == "a"sv);
+		CHECK(first_left->value(first.symbol_resolver()).view() == "a"sv);
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("V2Script Chunked Symbol Storage Parse", "[v2script-chunked-storage-parse]", testing::EncodingFallbackTypes) {
+	Parser parser(ovdl::detail::cnull);
+	parser.set_symbol_storage(symbol_storage::chunked);
+
+	parser.load_from_string(simple_buffer, TestType {});
+	CHECK_PARSE();
+
+	CHECK(parser.symbol_interner().size() == 2);
+	CHECK(parser.find_intern("a"sv).view() == "a"sv);
+	CHECK(parser.find_intern("b"sv).view() == "b"sv);
+}
+
+TEST_CASE("V2Script Chunked Symbol Storage Diagnostics", "[v2script-chunked-storage-parse]") {
+	// Covers the loggers' default constructed interners as well as the tiny file's own.
+	symbol_storage_scope scope { symbol_storage::chunked };
+
+	Parser parser(ovdl::detail::cnull);
+	parser.load_from_string("a = { \xC5\x92 = b }"sv);
+	CHECK_OR_RETURN(parser.simple_parse());
+	CHECK(parser.symbol_interner().size() == 3);
+	CHECK_FALSE_OR_RETURN(parser.get_errors().empty());
+	CHECK(parser.error(parser.get_errors().front()) == " warn: Buffer is UTF-8 encoded. This may cause problems. Prefer Windows-1252 encoding:"sv);
+
+	Parser missing(ovdl::detail::cnull);
+	missing.load_from_file("./Idontexist");
+	CHECK_FALSE_OR_RETURN(missing.get_errors().empty());
+	CHECK_FALSE(missing.error(missing.get_errors().front()).empty());
+}
+
+TEST_CASE("V2Script Node Positions", "[v2script-positions]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "a = b\r\nc = {\n\td = \"e f\"\n}"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	const ast::FileTree* file_tree = parser.get_file_node();
+	CHECK_OR_RETURN(file_tree);
+
+	std::vector<const ast::Node*> nodes;
+	for (auto [event, node] : dryad::traverse(file_tree)) {
+		if (event != dryad::traverse_event::exit) {
+			nodes.push_back(node);
+		}
+	}
+	// Reverse so the batch has to sort the locations.
+	std::reverse(nodes.begin(), nodes.end());
+
+	auto positions = parser.get_positions(nodes);
+	CHECK_OR_RETURN(positions.size() == nodes.size());
+
+	std::size_t mismatches = 0;
+	for (std::size_t i = 0; i < nodes.size(); ++i) {
+		auto single = parser.get_position(nodes[i]);
+		mismatches += single.start_line != positions[i].start_line || single.start_column != positions[i].start_column ||
+			single.end_line != positions[i].end_line || single.end_column != positions[i].end_column;
+	}
+	CHECK(mismatches == 0);
+
+	std::vector<const ast::Statement*> statements;
+	for (const auto* statement : file_tree->statements()) {
+		statements.push_back(statement);
+	}
+	CHECK_OR_RETURN(statements.size() == 2);
+
+	const auto* list_statement = dryad::node_try_cast<ast::AssignStatement>(statements[1]);
+	CHECK_OR_RETURN(list_statement);
+	auto left = parser.get_position(list_statement->left());
+	CHECK(left.start_line == 2);
+	CHECK(left.start_column == 1);
+
+	const auto* list = dryad::node_try_cast<ast::ListValue>(list_statement->right());
+	CHECK_OR_RETURN(list);
+	const auto* inner = dryad::node_try_cast<ast::AssignStatement>(list->statements().front());
+	CHECK_OR_RETURN(inner);
+	auto inner_left = parser.get_position(inner->left());
+	CHECK(inner_left.start_line == 3);
+	CHECK(inner_left.start_column == 2);
+	CHECK(parser.get_position(inner->right()).end_line == 3);
+}
+
+TEST_CASE("V2Script Key Lookup", "[v2script-key-lookup]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "a = 1\nb = { c = 2 c = 3 d = 4 }\na = 5\n\"e\" = 6"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	const ast::FileTree* file_tree = parser.get_file_node();
+	CHECK_OR_RETURN(file_tree);
+
+	auto value_of = [&](const ast::AssignStatement* statement) {
+		auto* value = dryad::node_try_cast<ast::FlatValue>(statement->right());
+		return value ? parser.value(value) : ""sv;
+	};
+
+	auto a = parser.find_all(file_tree, "a"sv);
+	CHECK_OR_RETURN(a.size() == 2);
+	CHECK(value_of(a[0]) == "1"sv);
+	CHECK(value_of(a[1]) == "5"sv);
+	CHECK(parser.find(file_tree, "a"sv) == a[0]);
+
+	CHECK_IF(parser.find(file_tree, "e"sv)) {
+		CHECK(value_of(parser.find(file_tree, "e"sv)) == "6"sv);
+	}
+
+	// Keys of nested lists are not indexed in their parent.
+	CHECK(parser.find(file_tree, "c"sv) == nullptr);
+	CHECK(parser.find_all(file_tree, "missing"sv).empty());
+
+	const auto* b = parser.find(file_tree, "b"sv);
+	CHECK_OR_RETURN(b);
+	const auto* list = b->right();
+
+	auto c = parser.find_all(list, parser.find_handle("c"sv));
+	CHECK_OR_RETURN(c.size() == 2);
+	CHECK(value_of(c[0]) == "2"sv);
+	CHECK(value_of(c[1]) == "3"sv);
+	CHECK_IF(parser.find(list, "d"sv)) {
+		CHECK(value_of(parser.find(list, "d"sv)) == "4"sv);
+	}
+	CHECK(parser.find(list, "a"sv) == nullptr);
+
+	// Repeated lookups hit the cached index.
+	CHECK(parser.find_all(list, "c"sv).data() == c.data());
+}
+
+TEST_CASE("V2Script Statement Count and Array", "[v2script-statement-array]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "color = { 10 20 30 }\nempty = {}"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	const ast::FileTree* file_tree = parser.get_file_node();
+	CHECK_OR_RETURN(file_tree);
+	CHECK(file_tree->statement_count() == 2);
+
+	auto top = parser.statement_array(file_tree);
+	CHECK_OR_RETURN(top.size() == 2);
+	CHECK(top[0] == file_tree->statements().front());
+	CHECK(parser.statement_at(file_tree, 2) == nullptr);
+
+	const auto* color = dryad::node_try_cast<ast::AssignStatement>(top[0]);
+	CHECK_OR_RETURN(color);
+	const auto* list = dryad::node_try_cast<ast::ListValue>(color->right());
+	CHECK_OR_RETURN(list);
+	CHECK(list->statement_count() == 3);
+
+	auto components = parser.statement_array(list);
+	CHECK_OR_RETURN(components.size() == 3);
+	const auto* blue = dryad::node_try_cast<ast::ValueStatement>(parser.statement_at(list, 2));
+	CHECK_OR_RETURN(blue);
+	const auto* blue_value = dryad::node_try_cast<ast::FlatValue>(blue->value());
+	CHECK_IF(blue_value) {
+		CHECK(parser.value(blue_value) == "30"sv);
+	}
+
+	const auto* empty = dryad::node_try_cast<ast::AssignStatement>(top[1]);
+	CHECK_OR_RETURN(empty);
+	const auto* empty_list = dryad::node_try_cast<ast::ListValue>(empty->right());
+	CHECK_OR_RETURN(empty_list);
+	CHECK(empty_list->statement_count() == 0);
+	CHECK(parser.statement_array(empty_list).empty());
+}
+
+TEST_CASE("V2Script Path Query", "[v2script-path-query]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer =
+		"political_decisions = {\n"
+		"\tfirst = { potential = { has_country_flag = a has_country_flag = b owns = 1 } }\n"
+		"\tsecond = { allow = { has_country_flag = c } potential = { has_country_flag = d } }\n"
+		"}\n"
+		"has_country_flag = e"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	auto values_of = [&](const ast::PathQuery& query) {
+		std::vector<std::string_view> result;
+		auto cursor = parser.query(query);
+		while (const auto* statement = cursor.next()) {
+			auto* value = dryad::node_try_cast<ast::FlatValue>(statement->right());
+			result.push_back(value ? parser.value(value) : ""sv);
+		}
+		return result;
+	};
+
+	auto flags = parser.compile_query("political_decisions/*/potential/has_country_flag"sv);
+	CHECK(flags.can_match());
+	CHECK(flags.steps().size() == 4);
+	auto flag_values = values_of(flags);
+	CHECK_OR_RETURN(flag_values.size() == 3);
+	CHECK(flag_values[0] == "a"sv);
+	CHECK(flag_values[1] == "b"sv);
+	CHECK(flag_values[2] == "d"sv);
+
+	auto decisions = parser.compile_query("political_decisions/*"sv);
+	CHECK(values_of(decisions).size() == 2);
+
+	auto top_level = values_of(parser.compile_query("has_country_flag"sv));
+	CHECK_OR_RETURN(top_level.size() == 1);
+	CHECK(top_level[0] == "e"sv);
+
+	auto missing = parser.compile_query("political_decisions/*/missing"sv);
+	CHECK_FALSE(missing.can_match());
+	CHECK(values_of(missing).empty());
+	CHECK_FALSE(parser.compile_query("political_decisions//potential"sv).can_match());
+
+	// Queries can start below the file, and a cursor restarts on reset.
+	const auto* root = parser.find(parser.get_file_node(), "political_decisions"sv);
+	CHECK_OR_RETURN(root);
+	auto potential = parser.compile_query("*/potential"sv);
+	auto cursor = parser.query(potential, root->right());
+	CHECK(cursor.next() != nullptr);
+	CHECK(cursor.next() != nullptr);
+	CHECK(cursor.next() == nullptr);
+	cursor.reset(root->right());
+	CHECK(cursor.next() != nullptr);
+}
+
+TEST_CASE("V2Script Flat Value Classes", "[v2script-flat-value-class]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "a = 0.25 b = -3 c = 1836.1.1 d = word e = \"12\" f = 99999999999999999999 g = 9221120237041090561"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	auto value_of = [&](std::string_view key) -> const ast::FlatValue* {
+		auto* statement = parser.find(parser.get_file_node(), key);
+		return statement ? dryad::node_try_cast<ast::FlatValue>(statement->right()) : nullptr;
+	};
+	auto ast_symbols = parser.symbol_resolver();
+
+	const auto* decimal = value_of("a"sv);
+	CHECK_OR_RETURN(decimal);
+	CHECK(decimal->value_class() == ast::FlatValueClass::Decimal);
+	CHECK(decimal->as_decimal(ast_symbols) == 0.25);
+	CHECK_FALSE(decimal->as_integer(ast_symbols));
+	// Cached on first decode.
+	CHECK(decimal->as_decimal(ast_symbols) == 0.25);
+
+	const auto* integer = value_of("b"sv);
+	CHECK_OR_RETURN(integer);
+	CHECK(integer->value_class() == ast::FlatValueClass::Integer);
+	CHECK(integer->as_integer(ast_symbols) == -3);
+	CHECK(integer->as_decimal(ast_symbols) == -3.0);
+
+	const auto* date = value_of("c"sv);
+	CHECK_OR_RETURN(date);
+	CHECK(date->value_class() == ast::FlatValueClass::Date);
+	CHECK(date->as_date(ast_symbols) == ast::FlatDate { 1836, 1, 1 });
+	CHECK_FALSE(date->as_decimal(ast_symbols));
+
+	const auto* word = value_of("d"sv);
+	CHECK_OR_RETURN(word);
+	CHECK(word->value_class() == ast::FlatValueClass::Word);
+	CHECK_FALSE(word->is_number());
+	CHECK_FALSE(word->as_decimal(ast_symbols));
+
+	const auto* string = value_of("e"sv);
+	CHECK_OR_RETURN(string);
+	CHECK(string->as_integer(ast_symbols) == 12);
+
+	const auto* overflow = value_of("f"sv);
+	CHECK_OR_RETURN(overflow);
+	CHECK(overflow->value_class() == ast::FlatValueClass::Integer);
+	CHECK_FALSE(overflow->as_integer(ast_symbols));
+	CHECK_FALSE(overflow->as_integer(ast_symbols));
+
+	// Equal to the pending cache marker, decoded again on every call instead of cached.
+	const auto* marker = value_of("g"sv);
+	CHECK_OR_RETURN(marker);
+	CHECK(marker->as_integer(ast_symbols) == 9221120237041090561);
+	CHECK(marker->as_integer(ast_symbols) == 9221120237041090561);
+}
+
+TEST_CASE("V2Script Fixed-Point Extraction", "[v2script-fixed-point]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "a = 0.1 b = -3 weights = { 0.25 1 -3.5 } mixed = { 1 word 2 } big = { 1 4294967296 }"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	auto ast_symbols = parser.symbol_resolver();
+	auto value_of = [&](std::string_view key) -> const ast::FlatValue* {
+		auto* statement = parser.find(parser.get_file_node(), key);
+		return statement ? dryad::node_try_cast<ast::FlatValue>(statement->right()) : nullptr;
+	};
+	auto list_of = [&](std::string_view key) -> const ast::ListValue* {
+		auto* statement = parser.find(parser.get_file_node(), key);
+		return statement ? dryad::node_try_cast<ast::ListValue>(statement->right()) : nullptr;
+	};
+
+	const auto* decimal = value_of("a"sv);
+	CHECK_OR_RETURN(decimal);
+	// Rounded to nearest from the exact decimal, not from the closest double.
+	CHECK(decimal->as_fixed_point(ast_symbols, 32) == 429496730);
+
+	const auto* integer = value_of("b"sv);
+	CHECK_OR_RETURN(integer);
+	CHECK(integer->as_fixed_point(ast_symbols, 16) == -3 * 65536);
+	CHECK_FALSE(integer->as_fixed_point(ast_symbols, 63));
+
+	std::array<std::int64_t, 3> values {};
+
+	auto weights = ast::extract_fixed_point(list_of("weights"sv), ast_symbols, 16, std::span(values));
+	CHECK(weights);
+	CHECK(weights.count == 3);
+	CHECK(values[0] == 16384);
+	CHECK(values[1] == 65536);
+	CHECK(values[2] == -229376);
+
+	auto too_many = ast::extract_fixed_point(list_of("weights"sv), ast_symbols, 16, std::span(values).first(2));
+	CHECK(too_many.error == ast::ExtractResult::Error::TooManyValues);
+	CHECK(too_many.count == 2);
+
+	auto mixed = ast::extract_fixed_point(list_of("mixed"sv), ast_symbols, 16, std::span(values));
+	CHECK(mixed.error == ast::ExtractResult::Error::NotNumeric);
+	CHECK(mixed.count == 1);
+	CHECK(mixed.failed_statement != nullptr);
+
+	auto big = ast::extract_fixed_point(list_of("big"sv), ast_symbols, 31, std::span(values));
+	CHECK(big.error == ast::ExtractResult::Error::OutOfRange);
+	CHECK(big.count == 1);
+}
+
+TEST_CASE("V2Script Numeric List Extraction", "[v2script-numeric-list]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "color = { 120 45 200 } position = { 12.5 -3 0.25 } bright = { 120 300 0 } named = { 1 two 3 } pops = { 1 2 3 4 }"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	auto ast_symbols = parser.symbol_resolver();
+	auto list_of = [&](std::string_view key) -> const ast::ListValue* {
+		auto* statement = parser.find(parser.get_file_node(), key);
+		return statement ? dryad::node_try_cast<ast::ListValue>(statement->right()) : nullptr;
+	};
+
+	std::array<std::uint8_t, 3> color {};
+	auto color_result = ast::extract_numbers(list_of("color"sv), ast_symbols, std::span(color));
+	CHECK(color_result);
+	CHECK(color_result.count == 3);
+	CHECK(color[0] == 120);
+	CHECK(color[1] == 45);
+	CHECK(color[2] == 200);
+
+	std::array<float, 3> position {};
+	auto position_result = ast::extract_numbers(list_of("position"sv), ast_symbols, std::span(position));
+	CHECK(position_result);
+	CHECK(position[0] == 12.5f);
+	CHECK(position[1] == -3.0f);
+	CHECK(position[2] == 0.25f);
+
+	// Decimals do not convert to integers.
+	std::array<std::int32_t, 3> integers {};
+	auto truncated = ast::extract_numbers(list_of("position"sv), ast_symbols, std::span(integers));
+	CHECK(truncated.error == ast::ExtractResult::Error::NotNumeric);
+	CHECK(truncated.count == 0);
+
+	auto bright = ast::extract_numbers(list_of("bright"sv), ast_symbols, std::span(color));
+	CHECK(bright.error == ast::ExtractResult::Error::OutOfRange);
+	CHECK(bright.count == 1);
+
+	auto named = ast::extract_numbers(list_of("named"sv), ast_symbols, std::span(integers));
+	CHECK(named.error == ast::ExtractResult::Error::NotNumeric);
+	CHECK(named.count == 1);
+	CHECK(named.failed_statement != nullptr);
+
+	auto pops = ast::extract_numbers(list_of("pops"sv), ast_symbols, std::span(integers));
+	CHECK(pops.error == ast::ExtractResult::Error::TooManyValues);
+	CHECK(pops.count == 3);
+	CHECK(integers[2] == 3);
+}
+
+TEST_CASE("V2Script Detach", "[v2script-detach]") {
+	Parser parser(ovdl::detail::cnull);
+
+	static constexpr auto buffer = "name = \"\xC5\x92uvre\"\ncolor = { 120 45 200 }\r\nnested = {\n\tkey = value\n}"sv;
+	parser.load_from_string(buffer);
+	CHECK_PARSE();
+
+	const auto* file_node = parser.get_file_node();
+	CHECK_OR_RETURN(file_node);
+	const auto* nested = parser.find(file_node, "nested"sv);
+	CHECK_OR_RETURN(nested);
+	auto nested_position = parser.get_position(nested);
+	const auto* key = parser.find(nested->right(), "key"sv);
+	CHECK_OR_RETURN(key);
+	auto key_position = parser.get_position(key);
+	const auto* color = parser.find(file_node, "color"sv);
+	CHECK_OR_RETURN(color);
+	auto color_position = parser.get_position(color);
+
+	auto detached = parser.detach();
+	CHECK_FALSE(parser.get_file_node());
+	CHECK_OR_RETURN(detached.has_file_node());
+	CHECK(detached.get_file_node() == file_node);
+
+	// Positions resolve without the buffer, including columns after the multibyte character.
+	auto detached_key_position = detached.get_position(key);
+	CHECK(detached_key_position.start_line == key_position.start_line);
+	CHECK(detached_key_position.start_column == key_position.start_column);
+	CHECK(detached_key_position.end_line == key_position.end_line);
+	CHECK(detached_key_position.end_column == key_position.end_column);
+	auto detached_nested_position = detached.get_position(nested);
+	CHECK(detached_nested_position.start_line == nested_position.start_line);
+	CHECK(detached_nested_position.end_line == nested_position.end_line);
+	CHECK(detached_nested_position.end_column == nested_position.end_column);
+	auto detached_color_position = detached.get_position(color);
+	CHECK(detached_color_position.start_line == 2);
+	CHECK(detached_color_position.end_column == color_position.end_column);
+
+	const auto* name = detached.find(detached.get_file_node(), "name"sv);
+	CHECK_OR_RETURN(name);
+	auto* name_value = dryad::node_try_cast<ast::FlatValue>(name->right());
+	CHECK_OR_RETURN(name_value);
+	CHECK(detached.value(name_value) == "\xC5\x92uvre"sv);
+	CHECK(detached.find(nested->right(), "key"sv) == key);
+	CHECK(detached.statement_array(detached.get_file_node()).size() == 3);
+
+	// The parser can load and parse again.
+	parser.load_from_string("a = b"sv);
+	CHECK_PARSE();
+	CHECK(detached.get_file_node() == file_node);
+
+	auto empty = Parser(ovdl::detail::cnull).detach();
+	CHECK_FALSE(empty.has_file_node());
+	CHECK(empty.get_position(key).is_empty());
+}
+
+TEST_CASE("V2Script Overlay View", "[v2script-overlay-view]") {
+	SymbolIntern::symbol_interner_type symbol_interner(1 << 16);
+
+	Parser base(symbol_interner, ovdl::detail::cnull);
+	Parser mod(symbol_interner, ovdl::detail::cnull);
+
+	base.load_from_string("decision = 1 ideology = { x = 1 } decision = 2 flag version = 1"sv);
+	mod.load_from_string("ideology = { y = 2 } decision = 3 version = 2"sv);
+	CHECK_OR_RETURN(base.simple_parse());
+	CHECK_OR_RETURN(mod.simple_parse());
+	CHECK_FALSE(base.has_error() || mod.has_error());
+
+	auto value_of = [&](const ast::Statement* statement) {
+		auto* assign = dryad::node_try_cast<ast::AssignStatement>(statement);
+		auto* value = assign ? dryad::node_try_cast<ast::FlatValue>(assign->right()) : nullptr;
+		return value ? value->value(symbol_interner).view() : ""sv;
+	};
+
+	ast::MergeRules rules;
+	rules.key_modes.insert(base.find_handle("ideology"sv), ast::MergeMode::Replace);
+	rules.key_modes.insert(base.find_handle("version"sv), ast::MergeMode::Replace);
+
+	const ast::Node* layers[] { base.get_file_node(), mod.get_file_node() };
+	ast::OverlayView view(layers, rules);
+
+	// decision = 1, decision = 2, flag, then the mod's ideology, decision = 3 and version = 2.
+	CHECK_OR_RETURN(view.size() == 6);
+	CHECK(view.statements()[0] == base.get_file_node()->statements().front());
+	CHECK(view.layer_of(2) == 0);
+	CHECK(view.layer_of(3) == 1);
+
+	auto decisions = view.find_all(base.find_handle("decision"sv));
+	CHECK_OR_RETURN(decisions.size() == 3);
+	CHECK(value_of(decisions[0]) == "1"sv);
+	CHECK(value_of(decisions[2]) == "3"sv);
+
+	auto versions = view.find_all(base.find_handle("version"sv));
+	CHECK_OR_RETURN(versions.size() == 1);
+	CHECK(value_of(versions[0]) == "2"sv);
+
+	const auto* ideology = view.find(base.find_handle("ideology"sv));
+	CHECK_OR_RETURN(ideology);
+	CHECK(ideology == mod.find(mod.get_file_node(), "ideology"sv));
+
+	// Everything is appended by default.
+	ast::OverlayView appended(layers, ast::MergeRules {});
+	CHECK(appended.size() == 8);
+	CHECK(appended.find_all(base.find_handle("ideology"sv)).size() == 2);
+}
+
+TEST_CASE("V2Script Forest", "[v2script-forest]") {
+	Forest forest;
+
+	const ast::AssignStatement* second_b = nullptr;
+	FilePosition second_b_position;
+	{
+		Parser parser(forest);
+		parser.load_from_string("a = 1\nb = { c = 2 }"sv);
+		CHECK_PARSE();
+		CHECK(forest.size() == 1);
+		// Nodes live in the forest's arena rather than the parser's own tree.
+		CHECK(parser.make_native_string() == "a = 1\nb = {\n  c = 2\n}"sv);
+		CHECK(parser.make_list_string().starts_with("- file tree: \n  - assign statement: \n    - identifier value: a\n"sv));
+
+		// The same parser loads the next file into the forest.
+		parser.load_from_string("b = \"\xC5\x92\" d = 3\n\tb = 4"sv);
+		CHECK_PARSE();
+		CHECK(forest.size() == 2);
+		CHECK(parser.get_file_node() == forest.file_node(1));
+		CHECK_FALSE(parser.detach().has_file_node());
+
+		auto bs = parser.find_all(parser.get_file_node(), "b"sv);
+		CHECK_OR_RETURN(bs.size() == 2);
+		second_b = bs[1];
+		second_b_position = parser.get_position(second_b);
+	}
+
+	// The parser and its buffers are gone.
+	CHECK_OR_RETURN(forest.size() == 2);
+	CHECK(forest.file_nodes().size() == 2);
+	CHECK(forest.file_path(0).empty());
+
+	auto value_of = [&](const ast::AssignStatement* statement) {
+		auto* value = dryad::node_try_cast<ast::FlatValue>(statement->right());
+		return value ? forest.value(value) : ""sv;
+	};
+
+	const auto* first_a = dryad::node_try_cast<ast::AssignStatement>(forest.file_node(0)->statements().front());
+	CHECK_OR_RETURN(first_a);
+	CHECK(value_of(first_a) == "1"sv);
+	CHECK(value_of(second_b) == "4"sv);
+
+	// Keys are interned once for all files.
+	auto* first_key = dryad::node_try_cast<ast::FlatValue>(first_a->left());
+	CHECK_OR_RETURN(first_key);
+	CHECK(first_key->handle() == forest.find_handle("a"sv));
+
+	auto position = forest.get_position(second_b);
+	CHECK(position.start_line == 2);
+	CHECK(position.start_line == second_b_position.start_line);
+	CHECK(position.start_column == second_b_position.start_column);
+	CHECK(position.end_column == second_b_position.end_column);
+
+	auto first_position = forest.get_position(first_a);
+	CHECK(first_position.start_line == 1);
+	CHECK(first_position.start_column == 1);
+}